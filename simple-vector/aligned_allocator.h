@@ -0,0 +1,118 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+// Аллокатор с выравниванием Alignment (по умолчанию - кеш-линия) для SimpleVector и ArrayPtr.
+// Блоки от HugePageThreshold байт берутся прямо у ядра через mmap, выровненными по границе
+// большой страницы (2 МиБ), и помечаются MADV_HUGEPAGE: ядро может отобразить их
+// прозрачными большими страницами и снизить промахи TLB. Если большие страницы недоступны
+// (THP выключены, ядро без поддержки, не Linux), madvise просто не действует и память
+// остаётся обычными страницами - отдельной ветки отказа нет.
+// Меньшие блоки выделяются выровненным operator new.
+// Порог SIZE_MAX отключает mmap
+template <typename Type, size_t Alignment = 64, size_t HugePageThreshold = size_t(2) << 20>
+class AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(Type), "Alignment must not be weaker than alignof(Type)");
+
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kAlignment = Alignment;
+    static constexpr size_t kHugePageThreshold = HugePageThreshold;
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    template <typename Other>
+    struct rebind {
+        using other = AlignedAllocator<Other, Alignment, HugePageThreshold>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) noexcept {
+    }
+
+    Type* allocate(size_t count) {
+        if(count > SIZE_MAX / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = count * sizeof(Type);
+        if(IsMapped(bytes)) {
+            return static_cast<Type*>(Map(bytes));
+        }
+        return static_cast<Type*>(::operator new(bytes, std::align_val_t(Alignment)));
+    }
+
+    // Способ освобождения определяется тем же порогом по размеру, что и при выделении
+    void deallocate(Type* ptr, size_t count) noexcept {
+        const size_t bytes = count * sizeof(Type);
+        if(IsMapped(bytes)) {
+            munmap(ptr, MappedBytes(bytes));
+        } else {
+            ::operator delete(ptr, bytes, std::align_val_t(Alignment));
+        }
+    }
+
+    template <typename Other>
+    bool operator==(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) const noexcept {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!=(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr size_t kMapAlignment = Alignment > kHugePageSize ? Alignment : kHugePageSize;
+
+    static bool IsMapped(size_t bytes) noexcept {
+        return bytes >= HugePageThreshold;
+    }
+
+    // Отображение занимает целое число больших страниц
+    static size_t MappedBytes(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    // mmap выравнивает только по обычной странице, поэтому отображается на kMapAlignment
+    // больше нужного, а лишнее по краям сразу возвращается ядру
+    static void* Map(size_t bytes) {
+        const size_t mapped_bytes = MappedBytes(bytes);
+        if(mapped_bytes > SIZE_MAX - kMapAlignment) {
+            throw std::bad_alloc();
+        }
+        const size_t reserved_bytes = mapped_bytes + kMapAlignment;
+        void* reserved = mmap(nullptr, reserved_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(reserved == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t first = reinterpret_cast<uintptr_t>(reserved);
+        const uintptr_t aligned = (first + kMapAlignment - 1) / kMapAlignment * kMapAlignment;
+        if(aligned != first) {
+            munmap(reserved, aligned - first);
+        }
+        const size_t tail = first + reserved_bytes - (aligned + mapped_bytes);
+        if(tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + mapped_bytes), tail);
+        }
+        void* result = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(result, mapped_bytes, MADV_HUGEPAGE);
+#endif
+        return result;
+    }
+};
+
+// SimpleVector с буфером, выровненным по кеш-линии, и большими страницами для больших буферов
+template <typename Type, size_t Alignment = 64, typename Growth = DoublingGrowth>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>, Growth>;
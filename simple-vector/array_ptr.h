@@ -3,27 +3,48 @@
 #include <cassert>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
-template <typename Type>
+// Владеет сырой (неинициализированной) памятью под массив элементов типа Type.
+// ArrayPtr только выделяет и освобождает память через аллокатор Alloc: создание и
+// разрушение элементов целиком лежит на владельце (SimpleVector), который знает,
+// какие ячейки заняты живыми объектами.
+template <typename Type, typename Alloc = std::allocator<Type>>
 class ArrayPtr {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>,
+                  "Alloc::value_type must be Type");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>,
+                  "Fancy pointers are not supported");
+
 public:
+    using Allocator = Alloc;
+
     // Инициализирует ArrayPtr нулевым указателем
     ArrayPtr() = default;
 
-    // Создаёт в куче массив из size элементов типа Type.
+    // Инициализирует ArrayPtr нулевым указателем и запоминает аллокатор
+    explicit ArrayPtr(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    // Выделяет через alloc память под size элементов типа Type, не создавая их.
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-    explicit ArrayPtr(size_t size) {
-        if(size == 0) {
-            raw_ptr_ = nullptr;
-        } else {
-            raw_ptr_ = new Type[size]{};
+    explicit ArrayPtr(size_t size, const Alloc& alloc = Alloc())
+        : alloc_(alloc) {
+        if(size != 0) {
+            raw_ptr_ = AllocTraits::allocate(alloc_, size);
+            size_ = size;
         }
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPtr(Type* raw_ptr) noexcept {
+    // Конструктор из сырого указателя на size ячеек, выделенных аллокатором alloc, либо nullptr
+    ArrayPtr(Type* raw_ptr, size_t size, const Alloc& alloc = Alloc()) noexcept
+        : alloc_(alloc) {
         raw_ptr_ = raw_ptr;
+        size_ = raw_ptr != nullptr ? size : 0;
     }
 
     //Копирующий конструктор
@@ -32,67 +53,95 @@ public:
     ArrayPtr& operator=(const ArrayPtr& rhs) = delete;
 
     //Перемещающий конструктор
-    ArrayPtr(ArrayPtr&& other) {
-        raw_ptr_ = std::move(other.raw_ptr_);
+    ArrayPtr(ArrayPtr&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
+        raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+        size_ = std::exchange(other.size_, 0);
     }
     //Перемещающее присваивание
-    ArrayPtr& operator=(ArrayPtr&& rhs) {
-        raw_ptr_ = std::move(rhs.raw_ptr_);
+    //Память освобождается тем аллокатором, которым выделена, поэтому аллокатор переезжает вместе с ней.
+    //Неприсваиваемые аллокаторы (std::pmr::polymorphic_allocator) должны быть равны: это проверяет владелец
+    ArrayPtr& operator=(ArrayPtr&& rhs) noexcept {
+        if(this != &rhs) {
+            Deallocate();
+            if constexpr(std::is_move_assignable_v<Alloc>) {
+                alloc_ = std::move(rhs.alloc_);
+            } else {
+                assert(alloc_ == rhs.alloc_);
+            }
+            raw_ptr_ = std::exchange(rhs.raw_ptr_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
         return *this;
     }
 
+    // Освобождает память. Элементы к этому моменту должны быть уже разрушены владельцем
     ~ArrayPtr() {
-    }
-
-    ArrayPtr& operator++() {
-        return *(raw_ptr_ + 1);
+        Deallocate();
     }
 
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
     // После вызова метода указатель на массив должен обнулиться
-    void Release() noexcept {
-        //Type* temp = raw_ptr_;
-        delete[] raw_ptr_;
-        raw_ptr_ = nullptr;
-        //return temp;
-    }
-
-    void Nullify() {
-        raw_ptr_ = nullptr;
+    [[nodiscard]] Type* Release() noexcept {
+        size_ = 0;
+        return std::exchange(raw_ptr_, nullptr);
     }
 
     // Возвращает ссылку на элемент массива с индексом index
     Type& operator[](size_t index) noexcept {
-        // Реализуйте операцию самостоятельно
         return *(raw_ptr_ + index);
     }
 
     // Возвращает константную ссылку на элемент массива с индексом index
     const Type& operator[](size_t index) const noexcept {
-        // Реализуйте операцию самостоятельно
         return *(raw_ptr_ + index);
     }
 
     // Возвращает true, если указатель ненулевой, и false в противном случае
     explicit operator bool() const {
-        // Заглушка. Реализуйте операцию самостоятельно
         return raw_ptr_ != nullptr;
     }
 
     // Возвращает значение сырого указателя, хранящего адрес начала массива
     Type* Get() const noexcept {
-        // Заглушка. Реализуйте метод самостоятельно
         return raw_ptr_;
     }
 
-    // Обменивается значениям указателя на массив с объектом other
+    // Возвращает количество выделенных ячеек
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает аллокатор, которым выделена память
+    const Alloc& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    Alloc& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    // Обменивается значениям указателя на массив и аллокатором с объектом other.
+    // Необмениваемые аллокаторы должны быть равны
     void swap(ArrayPtr& other) noexcept {
-        // Реализуйте метод самостоятельно
-        Type* temp = raw_ptr_;
-        raw_ptr_ = other.raw_ptr_;
-        other.raw_ptr_ = temp;
+        using std::swap;
+        if constexpr(std::is_swappable_v<Alloc>) {
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+        swap(raw_ptr_, other.raw_ptr_);
+        swap(size_, other.size_);
     }
 
 private:
+    void Deallocate() noexcept {
+        if(raw_ptr_ != nullptr) {
+            AllocTraits::deallocate(alloc_, raw_ptr_, size_);
+        }
+    }
+
+    [[no_unique_address]] Alloc alloc_;
     Type* raw_ptr_ = nullptr;
-};
\ No newline at end of file
+    size_t size_ = 0;
+};
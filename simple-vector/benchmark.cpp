@@ -0,0 +1,492 @@
+// Замеры производительности SimpleVector и его вариантов в сравнении с std::vector
+// (и boost::container::small_vector, если boost доступен).
+// Результат печатается в JSON в формате Google Benchmark, чтобы его можно было
+// сравнивать между версиями теми же инструментами (например, compare.py).
+// Если задан SIMPLE_VECTOR_BENCH_GOOGLE (цель simple_vector_benchmark в CMake делает это,
+// когда находит библиотеку benchmark), те же замеры запускает сама Google Benchmark
+// со своими ключами (--benchmark_filter, --benchmark_format и т.д.).
+//
+// Сборка:  g++ -std=c++17 -O2 -DNDEBUG -pthread benchmark.cpp -o benchmark
+//          или cmake --build <каталог сборки> --target simple_vector_benchmark
+// Запуск:  ./benchmark [--filter=<подстрока имени>] [--min_time=<секунды>] > result.json
+
+#include "simple_vector.h"
+#include "test_types.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef SIMPLE_VECTOR_BENCH_GOOGLE
+#include <benchmark/benchmark.h>
+#endif
+
+// GCC -O2 -Wall выдаёт ложные -Wstringop-overread/-Wstringop-overflow внутри
+// boost::small_vector (и в перемещении X, встроенном в его код): после встраивания он не
+// доказывает, что размер копии не превышает встроенный буфер. Предупреждения отключены
+// только для заголовка boost и его инстанцирования в AddForType
+#if __has_include(<boost/container/small_vector.hpp>)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+#include <boost/container/small_vector.hpp>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#define SIMPLE_VECTOR_BENCH_HAS_BOOST 1
+#endif
+
+using namespace std;
+
+namespace {
+
+// Тривиальная структура размером в кеш-линию
+struct Pod64 {
+    uint64_t fields[8];
+};
+
+bool operator==(const Pod64& lhs, const Pod64& rhs) {
+    return lhs.fields[0] == rhs.fields[0];
+}
+
+bool operator<(const Pod64& lhs, const Pod64& rhs) {
+    return lhs.fields[0] < rhs.fields[0];
+}
+
+template <typename Type>
+Type MakeValue(size_t i) {
+    if constexpr(is_same_v<Type, int>) {
+        return static_cast<int>(i);
+    } else if constexpr(is_same_v<Type, Pod64>) {
+        return Pod64{{i, i, i, i, i, i, i, i}};
+    } else if constexpr(is_same_v<Type, string>) {
+        // Длиннее SSO-буфера, чтобы строка владела памятью в куче
+        return string(32, static_cast<char>('a' + i % 26));
+    } else {
+        return Type(i);
+    }
+}
+
+template <typename Type>
+void DoNotOptimize(const Type& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Адаптеры к двум стилям интерфейса: SimpleVector (PushBack) и std::vector (push_back)
+template <typename Container, typename = void>
+struct IsStdStyle : false_type {};
+
+template <typename Container>
+struct IsStdStyle<Container, void_t<decltype(declval<Container&>().push_back(declval<typename Container::value_type>()))>>
+    : true_type {};
+
+template <typename Container, typename Value>
+void PushBack(Container& c, Value&& value) {
+    if constexpr(IsStdStyle<Container>::value) {
+        c.push_back(forward<Value>(value));
+    } else {
+        c.PushBack(forward<Value>(value));
+    }
+}
+
+template <typename Container, typename... Args>
+void EmplaceBack(Container& c, Args&&... args) {
+    if constexpr(IsStdStyle<Container>::value) {
+        c.emplace_back(forward<Args>(args)...);
+    } else {
+        c.EmplaceBack(forward<Args>(args)...);
+    }
+}
+
+template <typename Container, typename Value>
+void InsertAt(Container& c, size_t index, Value&& value) {
+    if constexpr(IsStdStyle<Container>::value) {
+        c.insert(c.begin() + index, forward<Value>(value));
+    } else {
+        c.Insert(c.begin() + index, forward<Value>(value));
+    }
+}
+
+template <typename Container>
+void EraseAt(Container& c, size_t index) {
+    if constexpr(IsStdStyle<Container>::value) {
+        c.erase(c.begin() + index);
+    } else {
+        c.Erase(c.begin() + index);
+    }
+}
+
+template <typename Container>
+size_t SizeOf(const Container& c) {
+    if constexpr(IsStdStyle<Container>::value) {
+        return c.size();
+    } else {
+        return c.GetSize();
+    }
+}
+
+template <typename Type, typename Container>
+Container Filled(size_t size) {
+    Container c;
+    for(size_t i = 0; i < size; ++i) {
+        PushBack(c, MakeValue<Type>(i));
+    }
+    return c;
+}
+
+struct BenchmarkResult {
+    string name;
+    size_t iterations = 0;
+    double ns_per_iteration = 0;
+    double items_per_second = 0;
+};
+
+using Iteration = function<chrono::nanoseconds()>;
+
+struct Benchmark {
+    string name;
+    size_t items_per_iteration;
+    // Готовит общие для всех итераций данные и возвращает функцию,
+    // которая выполняет одну итерацию и возвращает время её измеряемой части
+    function<Iteration()> setup;
+};
+
+// Повторяет итерации, пока суммарное измеренное время не превысит min_time
+[[maybe_unused]] BenchmarkResult Run(const Benchmark& benchmark, double min_time) {
+    const auto budget = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double>(min_time));
+    const Iteration run = benchmark.setup();
+    chrono::nanoseconds total{0};
+    size_t iterations = 0;
+    while(total < budget || iterations == 0) {
+        total += run();
+        ++iterations;
+    }
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.ns_per_iteration = static_cast<double>(total.count()) / iterations;
+    result.items_per_second = benchmark.items_per_iteration * 1e9 / result.ns_per_iteration;
+    return result;
+}
+
+template <typename Body>
+chrono::nanoseconds Measure(Body body) {
+    const auto start = chrono::steady_clock::now();
+    body();
+    return chrono::steady_clock::now() - start;
+}
+
+enum class Position { kFront, kMiddle, kBack };
+
+size_t IndexFor(Position position, size_t size) {
+    switch(position) {
+        case Position::kFront:
+            return 0;
+        case Position::kMiddle:
+            return size / 2;
+        default:
+            return size;
+    }
+}
+
+const char* NameOf(Position position) {
+    switch(position) {
+        case Position::kFront:
+            return "Front";
+        case Position::kMiddle:
+            return "Middle";
+        default:
+            return "Back";
+    }
+}
+
+// Регистрирует набор замеров для контейнера Container с элементами Type
+template <typename Type, typename Container>
+void AddBenchmarks(vector<Benchmark>& out, const string& container_name, const string& type_name,
+                   size_t growth_size) {
+    const string suffix = "<" + container_name + "<" + type_name + ">>";
+    constexpr size_t kAppendCount = 10000;
+    constexpr size_t kShiftSize = 2000;
+    constexpr size_t kCopySize = 100000;
+
+    out.push_back({"BM_PushBack" + suffix + "/" + to_string(kAppendCount), kAppendCount, [] {
+        return Iteration([] {
+            Container c;
+            return Measure([&] {
+                for(size_t i = 0; i < kAppendCount; ++i) {
+                    PushBack(c, MakeValue<Type>(i));
+                }
+                DoNotOptimize(c);
+            });
+        });
+    }});
+
+    // Pod64 - агрегат без конструктора из аргументов: создавать на месте нечего, замер был бы копией BM_PushBack
+    if constexpr(!is_same_v<Type, Pod64>) {
+        out.push_back({"BM_EmplaceBack" + suffix + "/" + to_string(kAppendCount), kAppendCount, [] {
+            return Iteration([] {
+                Container c;
+                return Measure([&] {
+                    for(size_t i = 0; i < kAppendCount; ++i) {
+                        if constexpr(is_same_v<Type, string>) {
+                            EmplaceBack(c, size_t{32}, static_cast<char>('a' + i % 26));
+                        } else {
+                            EmplaceBack(c, i);
+                        }
+                    }
+                    DoNotOptimize(c);
+                });
+            });
+        }});
+    }
+
+    out.push_back({"BM_Growth" + suffix + "/" + to_string(growth_size), growth_size, [growth_size] {
+        return Iteration([growth_size] {
+            Container c;
+            return Measure([&] {
+                for(size_t i = 0; i < growth_size; ++i) {
+                    PushBack(c, MakeValue<Type>(i));
+                }
+                DoNotOptimize(c);
+            });
+        });
+    }});
+
+    for(Position position : {Position::kFront, Position::kMiddle, Position::kBack}) {
+        out.push_back({"BM_Insert" + string(NameOf(position)) + suffix + "/" + to_string(kShiftSize), kShiftSize,
+                       [position] {
+            return Iteration([position] {
+                Container c;
+                return Measure([&] {
+                    for(size_t i = 0; i < kShiftSize; ++i) {
+                        InsertAt(c, IndexFor(position, SizeOf(c)), MakeValue<Type>(i));
+                    }
+                    DoNotOptimize(c);
+                });
+            });
+        }});
+
+        out.push_back({"BM_Erase" + string(NameOf(position)) + suffix + "/" + to_string(kShiftSize), kShiftSize,
+                       [position] {
+            return Iteration([position] {
+                Container c = Filled<Type, Container>(kShiftSize);
+                return Measure([&] {
+                    for(size_t i = 0; i < kShiftSize; ++i) {
+                        const size_t size = SizeOf(c);
+                        EraseAt(c, min(IndexFor(position, size), size - 1));
+                    }
+                    DoNotOptimize(c);
+                });
+            });
+        }});
+    }
+
+    // Данные для замеров ниже создаются один раз и общие для всех итераций
+    if constexpr(is_copy_constructible_v<Type>) {
+        out.push_back({"BM_Copy" + suffix + "/" + to_string(kCopySize), kCopySize, [] {
+            auto source = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            return Iteration([source] {
+                return Measure([&] {
+                    Container copy(*source);
+                    DoNotOptimize(copy);
+                });
+            });
+        }});
+
+        out.push_back({"BM_Equal" + suffix + "/" + to_string(kCopySize), kCopySize, [] {
+            auto lhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            auto rhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            return Iteration([lhs, rhs] {
+                return Measure([&] {
+                    DoNotOptimize(*lhs == *rhs);
+                });
+            });
+        }});
+
+        // < и <= замеряются отдельно: <= у SimpleVector проходит данные один раз, а не через !(rhs < lhs)
+        out.push_back({"BM_Less" + suffix + "/" + to_string(kCopySize), kCopySize, [] {
+            auto lhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            auto rhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            return Iteration([lhs, rhs] {
+                return Measure([&] {
+                    DoNotOptimize(*lhs < *rhs);
+                });
+            });
+        }});
+
+        out.push_back({"BM_LessOrEqual" + suffix + "/" + to_string(kCopySize), kCopySize, [] {
+            auto lhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            auto rhs = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+            return Iteration([lhs, rhs] {
+                return Measure([&] {
+                    DoNotOptimize(*lhs <= *rhs);
+                });
+            });
+        }});
+    }
+
+    constexpr size_t kMoves = 1000;
+    out.push_back({"BM_Move" + suffix + "/" + to_string(kCopySize), kMoves, [] {
+        auto source = make_shared<Container>(Filled<Type, Container>(kCopySize));
+        return Iteration([source] {
+            return Measure([&] {
+                for(size_t i = 0; i < kMoves; ++i) {
+                    Container target(move(*source));
+                    *source = move(target);
+                }
+                DoNotOptimize(*source);
+            });
+        });
+    }});
+
+    out.push_back({"BM_Iterate" + suffix + "/" + to_string(kCopySize), kCopySize, [] {
+        auto c = make_shared<const Container>(Filled<Type, Container>(kCopySize));
+        return Iteration([c] {
+            return Measure([&] {
+                size_t touched = 0;
+                for(const auto& item : *c) {
+                    DoNotOptimize(item);
+                    ++touched;
+                }
+                DoNotOptimize(touched);
+            });
+        });
+    }});
+}
+
+template <typename Type>
+void AddForType(vector<Benchmark>& out, const string& type_name, size_t growth_size) {
+    AddBenchmarks<Type, vector<Type>>(out, "std::vector", type_name, growth_size);
+    AddBenchmarks<Type, SimpleVector<Type>>(out, "SimpleVector", type_name, growth_size);
+    AddBenchmarks<Type, SimpleVector<Type, allocator<Type>, HalfGrowth>>(
+        out, "SimpleVector/HalfGrowth", type_name, growth_size);
+    AddBenchmarks<Type, SimpleVector<Type, allocator<Type>, AllocatorSizeClassGrowth<>>>(
+        out, "SimpleVector/SizeClassGrowth", type_name, growth_size);
+    AddBenchmarks<Type, SmallSimpleVector<Type, 8>>(out, "SmallSimpleVector/8", type_name, growth_size);
+#ifdef SIMPLE_VECTOR_BENCH_HAS_BOOST
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+    AddBenchmarks<Type, boost::container::small_vector<Type, 8>>(out, "boost::small_vector/8", type_name, growth_size);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+}
+
+string EscapeJson(const string& text) {
+    string result;
+    for(char c : text) {
+        if(c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+[[maybe_unused]] void PrintJson(ostream& out, const vector<BenchmarkResult>& results) {
+    char date[64];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for(size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+        out << "      \"run_name\": \"" << EscapeJson(result.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"real_time\": " << result.ns_per_iteration << ",\n";
+        out << "      \"cpu_time\": " << result.ns_per_iteration << ",\n";
+        out << "      \"time_unit\": \"ns\",\n";
+        out << "      \"items_per_second\": " << result.items_per_second << "\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+vector<Benchmark> AllBenchmarks() {
+    vector<Benchmark> benchmarks;
+    AddForType<int>(benchmarks, "int", 10'000'000);
+    AddForType<Pod64>(benchmarks, "Pod64", 1'000'000);
+    AddForType<string>(benchmarks, "std::string", 1'000'000);
+    AddForType<X>(benchmarks, "X", 1'000'000);
+    return benchmarks;
+}
+
+} // namespace
+
+#ifdef SIMPLE_VECTOR_BENCH_GOOGLE
+
+// Каждый замер регистрируется в Google Benchmark с ручным временем:
+// подготовка итерации не входит в измерение так же, как в собственном цикле Run
+int main(int argc, char** argv) {
+    for(const Benchmark& benchmark : AllBenchmarks()) {
+        benchmark::RegisterBenchmark(benchmark.name.c_str(), [benchmark](benchmark::State& state) {
+            const Iteration run = benchmark.setup();
+            for(auto _ : state) {
+                state.SetIterationTime(chrono::duration<double>(run()).count());
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * benchmark.items_per_iteration));
+        })->UseManualTime();
+    }
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    string filter;
+    double min_time = 0.1;
+    for(int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if(arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(9);
+        } else if(arg.rfind("--min_time=", 0) == 0) {
+            min_time = stod(arg.substr(11));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--filter=<substring>] [--min_time=<seconds>]" << endl;
+            return 1;
+        }
+    }
+
+    vector<BenchmarkResult> results;
+    for(const Benchmark& benchmark : AllBenchmarks()) {
+        if(benchmark.name.find(filter) == string::npos) {
+            continue;
+        }
+        results.push_back(Run(benchmark, min_time));
+        cerr << results.back().name << ": " << results.back().ns_per_iteration << " ns" << endl;
+    }
+    PrintJson(cout, results);
+    return 0;
+}
+
+#endif
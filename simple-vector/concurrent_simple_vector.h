@@ -0,0 +1,249 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор для одновременного добавления из многих потоков.
+// Элементы лежат в сегментах, размер которых растёт вдвое (16, 32, 64, ...), и никогда
+// не переезжают: ссылки и указатели на них действительны до разрушения вектора или Clear.
+// PushBack и EmplaceBack не берут блокировок: ячейка занимается через compare_exchange
+// после того, как её сегмент выделен и опубликован (тоже через compare_exchange).
+// Размер GetSize() публикуется по порядку: все элементы с индексом меньше него уже
+// созданы, и их можно читать из любого потока одновременно с добавлением новых.
+template <typename Type>
+class ConcurrentSimpleVector {
+    static_assert(std::is_nothrow_move_constructible_v<Type>,
+                  "Type must be nothrow move constructible: a claimed slot must always be filled");
+
+public:
+    ConcurrentSimpleVector() = default;
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ~ConcurrentSimpleVector() {
+        Clear();
+    }
+
+    // Добавляет элемент в конец, возвращает ссылку на него.
+    // Конструктор, который может бросить исключение, и выделение сегмента выполняются
+    // до занятия ячейки, поэтому при исключении вектор не меняется
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if constexpr(std::is_nothrow_constructible_v<Type, Args...>) {
+            return Publish(Claim(), std::forward<Args>(args)...);
+        } else {
+            Type value(std::forward<Args>(args)...);
+            return Publish(Claim(), std::move(value));
+        }
+    }
+
+    Type& PushBack(const Type& item) {
+        return EmplaceBack(item);
+    }
+
+    Type& PushBack(Type&& item) {
+        return EmplaceBack(std::move(item));
+    }
+
+    // Количество опубликованных элементов: все элементы с меньшими индексами уже созданы
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Вместимость выделенных сегментов
+    size_t GetCapacity() const noexcept {
+        size_t capacity = 0;
+        for(size_t segment = 0; segment < kMaxSegments; ++segment) {
+            if(segments_[segment].load(std::memory_order_acquire) != nullptr) {
+                capacity = SegmentStart(segment + 1);
+            }
+        }
+        return capacity;
+    }
+
+    // Возвращает ссылку на элемент с индексом index < GetSize()
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return Slot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= GetSize()
+    Type& At(size_t index) {
+        if(index >= GetSize()) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return Slot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if(index >= GetSize()) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return Slot(index);
+    }
+
+    // Заранее выделяет сегменты под capacity элементов. Можно вызывать одновременно с добавлением
+    void Reserve(size_t capacity) {
+        for(size_t segment = 0; segment < kMaxSegments && SegmentStart(segment) < capacity; ++segment) {
+            GetSegment(segment);
+        }
+    }
+
+    // Копирует опубликованные элементы в обычный SimpleVector
+    SimpleVector<Type> ToSimpleVector() const {
+        const size_t size = GetSize();
+        SimpleVector<Type> result(::Reserve(size));
+        for(size_t index = 0; index < size; ++index) {
+            result.PushBack(Slot(index));
+        }
+        return result;
+    }
+
+    // Разрушает все элементы и освобождает память. Не потокобезопасен:
+    // добавления и чтения в это время недопустимы
+    void Clear() noexcept {
+        const size_t claimed = claimed_.load(std::memory_order_acquire);
+        for(size_t segment = 0; segment < kMaxSegments; ++segment) {
+            std::unique_ptr<Segment> owned(segments_[segment].exchange(nullptr, std::memory_order_acq_rel));
+            if(!owned) {
+                continue;
+            }
+            const size_t start = SegmentStart(segment);
+            const size_t count = claimed > start ? std::min(claimed - start, SegmentSize(segment)) : 0;
+            for(size_t offset = 0; offset < count; ++offset) {
+                if(owned->ready[offset].load(std::memory_order_acquire)) {
+                    std::destroy_at(owned->items.Get() + offset);
+                }
+            }
+        }
+        claimed_.store(0, std::memory_order_relaxed);
+        size_.store(0, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t kFirstSegmentBits = 4;
+    static constexpr size_t kFirstSegmentSize = size_t{1} << kFirstSegmentBits;
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kFirstSegmentBits;
+
+    // Сегмент: сырая память под элементы и флаги готовности ячеек
+    struct Segment {
+        explicit Segment(size_t size)
+            : items(size), ready(new std::atomic<bool>[size]()) {
+        }
+
+        ArrayPtr<Type> items;
+        std::unique_ptr<std::atomic<bool>[]> ready;
+    };
+
+    static size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    // Индекс первого элемента сегмента
+    static size_t SegmentStart(size_t segment) noexcept {
+        return SegmentSize(segment) - kFirstSegmentSize;
+    }
+
+    // Сегмент, в котором лежит элемент index: index + kFirstSegmentSize
+    // попадает в [SegmentSize(segment), 2 * SegmentSize(segment))
+    static size_t SegmentOf(size_t index) noexcept {
+        return HighestBit(index + kFirstSegmentSize) - kFirstSegmentBits;
+    }
+
+    static size_t HighestBit(size_t value) noexcept {
+#if defined(__GNUC__)
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(value);
+#else
+        size_t bit = 0;
+        while(value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    // Возвращает сегмент, выделяя его при необходимости. Из нескольких потоков,
+    // выделивших сегмент одновременно, публикует свой только один, остальные освобождают
+    Segment& GetSegment(size_t segment) {
+        Segment* current = segments_[segment].load(std::memory_order_acquire);
+        if(current != nullptr) {
+            return *current;
+        }
+        auto fresh = std::make_unique<Segment>(SegmentSize(segment));
+        if(segments_[segment].compare_exchange_strong(current, fresh.get(), std::memory_order_acq_rel)) {
+            return *fresh.release();
+        }
+        return *current;
+    }
+
+    Type& Slot(size_t index) const noexcept {
+        const size_t segment = SegmentOf(index);
+        return segments_[segment].load(std::memory_order_acquire)->items[index - SegmentStart(segment)];
+    }
+
+    // Занимает следующую ячейку и возвращает её индекс. Сегмент ячейки выделяется до того,
+    // как она занята: пропустить занятую ячейку нельзя, опубликованный размер навсегда
+    // остановился бы на ней, поэтому нехватка памяти должна случиться раньше
+    size_t Claim() {
+        size_t index = claimed_.load(std::memory_order_relaxed);
+        do {
+            GetSegment(SegmentOf(index));
+        } while(!claimed_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+        return index;
+    }
+
+    // Создаёт элемент в занятой ячейке index, отмечает её готовой и продвигает опубликованный размер.
+    // Сегмент ячейки уже выделен в Claim
+    template <typename... Args>
+    Type& Publish(size_t index, Args&&... args) noexcept {
+        const size_t segment = SegmentOf(index);
+        const size_t offset = index - SegmentStart(segment);
+        Segment* target = segments_[segment].load(std::memory_order_acquire);
+        Type* item = new (target->items.Get() + offset) Type(std::forward<Args>(args)...);
+        target->ready[offset].store(true);
+        AdvanceSize();
+        return *item;
+    }
+
+    // Сдвигает size_ через все готовые подряд ячейки. Каждый добавивший поток помогает
+    // продвинуть размер, поэтому элемент, готовый раньше предшественников, будет
+    // опубликован тем потоком, который заполнит последнюю ячейку перед ним.
+    // Флаги готовности и size_ используют seq_cst: иначе два потока, заполнившие соседние
+    // ячейки, могли бы не увидеть флаги друг друга, и размер остановился бы
+    void AdvanceSize() noexcept {
+        size_t size = size_.load();
+        while(size < claimed_.load()) {
+            const size_t segment = SegmentOf(size);
+            const Segment* current = segments_[segment].load();
+            if(current == nullptr || !current->ready[size - SegmentStart(segment)].load()) {
+                return;
+            }
+            if(size_.compare_exchange_weak(size, size + 1)) {
+                ++size;
+            }
+        }
+    }
+
+    std::atomic<Segment*> segments_[kMaxSegments] = {};
+    alignas(64) std::atomic<size_t> claimed_{0};
+    alignas(64) std::atomic<size_t> size_{0};
+};
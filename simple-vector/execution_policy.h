@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+class ThreadPool;
+
+// Политика выполнения для конструкторов, Resize и параллельных алгоритмов SimpleVector.
+// Пул известен политике только по указателю, а его ParallelFor вызывается через
+// функцию parallel_for, которую подставляет Parallel() из thread_pool.h. Поэтому
+// SimpleVector не зависит от потоков, а пул подключается только там, где он нужен
+class ExecutionPolicy {
+public:
+    using ChunkFn = void (*)(void* body, size_t chunk);
+    using ParallelForFn = void (*)(ThreadPool* pool, size_t chunks, void* body, ChunkFn call);
+
+    // Последовательное выполнение
+    constexpr ExecutionPolicy() noexcept = default;
+
+    ExecutionPolicy(ThreadPool* pool, size_t concurrency, ParallelForFn parallel_for) noexcept
+        : pool_(pool), concurrency_(pool != nullptr ? concurrency : 1), parallel_for_(parallel_for) {
+    }
+
+    // Пул, на котором выполняется работа, либо nullptr для последовательного выполнения
+    ThreadPool* GetPool() const noexcept {
+        return pool_;
+    }
+
+    // Сколько потоков одновременно выполняют ParallelFor
+    size_t GetConcurrency() const noexcept {
+        return concurrency_;
+    }
+
+    // Вызывает body(chunk) для каждого chunk из [0, chunks) на пуле политики и ждёт завершения
+    template <typename Body>
+    void ParallelFor(size_t chunks, Body&& body) const {
+        if(pool_ == nullptr || chunks <= 1) {
+            for(size_t chunk = 0; chunk < chunks; ++chunk) {
+                body(chunk);
+            }
+            return;
+        }
+        using BodyType = std::remove_reference_t<Body>;
+        parallel_for_(pool_, chunks, const_cast<void*>(static_cast<const void*>(std::addressof(body))),
+                      [](void* erased, size_t chunk) {
+            (*static_cast<BodyType*>(erased))(chunk);
+        });
+    }
+
+private:
+    ThreadPool* pool_ = nullptr;
+    size_t concurrency_ = 1;
+    ParallelForFn parallel_for_ = nullptr;
+};
+
+// Последовательное выполнение в вызывающем потоке
+inline ExecutionPolicy Sequential() noexcept {
+    return ExecutionPolicy();
+}
+
+// Разбиение массива из size элементов на куски для параллельной обработки.
+// Внутренние границы кусков лежат на границах кеш-линий, поэтому два потока
+// никогда не пишут в одну линию. Маленькие массивы остаются одним куском
+template <typename Type>
+class ChunkPlan {
+public:
+    static constexpr size_t kCacheLine = 64;
+    // Меньшие куски не окупают передачу задачи другому потоку
+    static constexpr size_t kMinChunkBytes = 64 * 1024;
+
+    ChunkPlan(const Type* data, size_t size, ExecutionPolicy policy) noexcept
+        : size_(size) {
+        const size_t concurrency = policy.GetConcurrency();
+        if(concurrency == 1 || size * sizeof(Type) < 2 * kMinChunkBytes) {
+            return;
+        }
+        // Кусок - целое число кеш-линий, если элемент укладывается в линию без остатка
+        const size_t line = kCacheLine % sizeof(Type) == 0 ? kCacheLine / sizeof(Type) : 1;
+        const size_t min_chunk = std::max<size_t>(kMinChunkBytes / sizeof(Type), 1);
+        // Несколько кусков на поток сглаживают неравномерную нагрузку
+        chunk_ = std::max(min_chunk, (size + concurrency * 4 - 1) / (concurrency * 4));
+        chunk_ = (chunk_ + line - 1) / line * line;
+        const size_t misalignment = reinterpret_cast<uintptr_t>(data) % kCacheLine;
+        head_ = line == 1 || misalignment % sizeof(Type) != 0 ? 0 : (kCacheLine - misalignment) % kCacheLine / sizeof(Type);
+        head_ = std::min(head_, size);
+        // Первый кусок дополнительно забирает элементы до первой границы линии
+        count_ = std::max<size_t>((size - head_) / chunk_, 1);
+    }
+
+    size_t GetCount() const noexcept {
+        return count_;
+    }
+
+    // Начало куска с номером index
+    size_t Begin(size_t index) const noexcept {
+        return index == 0 ? 0 : head_ + index * chunk_;
+    }
+
+    // Конец куска с номером index
+    size_t End(size_t index) const noexcept {
+        return index + 1 == count_ ? size_ : Begin(index + 1);
+    }
+
+private:
+    size_t size_;
+    size_t chunk_ = 0;
+    size_t head_ = 0;
+    size_t count_ = 1;
+};
+
+// Вызывает body(begin, end) для кусков [0, size) массива data согласно ChunkPlan
+template <typename Type, typename Body>
+void ParallelForChunks(const Type* data, size_t size, ExecutionPolicy policy, Body&& body) {
+    const ChunkPlan<Type> plan(data, size, policy);
+    if(plan.GetCount() == 1) {
+        body(size_t{0}, size);
+        return;
+    }
+    policy.ParallelFor(plan.GetCount(), [&](size_t chunk) {
+        body(plan.Begin(chunk), plan.End(chunk));
+    });
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+#include "flat_set.h"
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+// Упорядоченный словарь на двух SimpleVector: отсортированные ключи и значения
+// в отдельных массивах с общими индексами. Поиск без ветвлений идёт только по ключам,
+// поэтому в кеш попадают только они; значения читаются по найденному индексу.
+// Пакетная вставка, ExtractSequence и AdoptSequence - как у FlatSet.
+// Элемент при обходе - пара ссылок (ключ, значение)
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap {
+    template <bool kConst>
+    class EntryIterator {
+        using Owner = std::conditional_t<kConst, const FlatMap, FlatMap>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, Value>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, std::conditional_t<kConst, const Value&, Value&>>;
+        using pointer = void;
+
+        EntryIterator() = default;
+
+        EntryIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        // Константный итератор из неконстантного
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        EntryIterator(const EntryIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return {owner_->keys_[index_], owner_->values_[index_]};
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        EntryIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        EntryIterator operator++(int) noexcept {
+            EntryIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        EntryIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        EntryIterator operator--(int) noexcept {
+            EntryIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        EntryIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        EntryIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend EntryIterator operator+(EntryIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend EntryIterator operator+(difference_type offset, EntryIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend EntryIterator operator-(EntryIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator<=(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>=(const EntryIterator& lhs, const EntryIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        friend class EntryIterator<!kConst>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Iterator = EntryIterator<false>;
+    using ConstIterator = EntryIterator<true>;
+    using KeySequence = SimpleVector<Key>;
+    using ValueSequence = SimpleVector<Value>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatMap(std::initializer_list<std::pair<Key, Value>> init, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertMany(init.begin(), init.end());
+    }
+
+    // Создаёт словарь из диапазона пар (ключ, значение)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertMany(first, last);
+    }
+
+    // Забирает ключи и значения без копирования, упорядочивает их и удаляет повторы ключей
+    FlatMap(KeySequence&& keys, ValueSequence&& values, const Compare& comp = Compare())
+        : keys_(std::move(keys)), values_(std::move(values)), comp_(comp) {
+        assert(keys_.GetSize() == values_.GetSize());
+        MergeTail(0);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Упорядоченные ключи
+    const KeySequence& Keys() const noexcept {
+        return keys_;
+    }
+
+    // Значения в порядке ключей
+    const ValueSequence& Values() const noexcept {
+        return values_;
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+        values_.Reserve(new_capacity);
+    }
+
+    Iterator Find(const Key& key) {
+        return Iterator(this, FindIndex(key));
+    }
+
+    ConstIterator Find(const Key& key) const {
+        return ConstIterator(this, FindIndex(key));
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != GetSize();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Первая запись с ключом, не меньшим key
+    ConstIterator LowerBound(const Key& key) const {
+        return ConstIterator(this, LowerBoundIndex(key));
+    }
+
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        return values_[CheckedIndex(key)];
+    }
+
+    const Value& At(const Key& key) const {
+        return values_[CheckedIndex(key)];
+    }
+
+    // Возвращает значение по ключу, вставляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        return (*Emplace(key)).second;
+    }
+
+    // Вставляет запись, если ключа нет. Возвращает итератор на запись и признак вставки
+    std::pair<Iterator, bool> Insert(Key key, Value value) {
+        const size_t index = LowerBoundIndex(key);
+        if(index != GetSize() && !comp_(key, keys_[index])) {
+            return {Iterator(this, index), false};
+        }
+        return {InsertAt(index, std::move(key), std::move(value)), true};
+    }
+
+    // Вставляет запись или заменяет значение существующей
+    Iterator InsertOrAssign(Key key, Value value) {
+        const size_t index = LowerBoundIndex(key);
+        if(index != GetSize() && !comp_(key, keys_[index])) {
+            values_[index] = std::move(value);
+            return Iterator(this, index);
+        }
+        return InsertAt(index, std::move(key), std::move(value));
+    }
+
+    // Дописывает пары [first, last) в конец, упорядочивает их и сливает с имеющимися
+    // за один проход. Из записей с равными ключами остаётся уже имевшаяся
+    // или первая из добавленных
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void InsertMany(InputIt first, InputIt last) {
+        const size_t old_size = GetSize();
+        try {
+            for(; first != last; ++first) {
+                auto&& entry = *first;
+                keys_.PushBack(std::forward<decltype(entry)>(entry).first);
+                values_.PushBack(std::forward<decltype(entry)>(entry).second);
+            }
+            MergeTail(old_size);
+        } catch(...) {
+            keys_.EraseRange(keys_.begin() + old_size, keys_.end());
+            values_.EraseRange(values_.begin() + std::min(old_size, values_.GetSize()), values_.end());
+            throw;
+        }
+    }
+
+    // Удаляет запись с ключом key, возвращает количество удалённых (0 или 1)
+    size_t Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if(index == GetSize()) {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.GetIndex() < GetSize());
+        EraseAt(pos.GetIndex());
+        return Iterator(this, pos.GetIndex());
+    }
+
+    // Отдаёт ключи и значения без копирования, словарь становится пустым
+    std::pair<KeySequence, ValueSequence> ExtractSequence() noexcept {
+        std::pair<KeySequence, ValueSequence> result;
+        result.first.swap(keys_);
+        result.second.swap(values_);
+        return result;
+    }
+
+    // Забирает ключи и значения без копирования. Ключи должны быть строго упорядочены по Compare,
+    // значения - идти в том же порядке
+    void AdoptSequence(KeySequence&& keys, ValueSequence&& values) noexcept {
+        assert(keys.GetSize() == values.GetSize());
+        assert(flat_detail::IsStrictlySorted(keys.begin(), keys.end(), comp_));
+        KeySequence(std::move(keys)).swap(keys_);
+        ValueSequence(std::move(values)).swap(values_);
+    }
+
+    void swap(FlatMap& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(comp_, other.comp_);
+    }
+
+private:
+    size_t LowerBoundIndex(const Key& key) const {
+        return flat_detail::LowerBound(keys_.cbegin(), keys_.GetSize(), key, comp_) - keys_.cbegin();
+    }
+
+    // Индекс записи с ключом key или GetSize(), если её нет
+    size_t FindIndex(const Key& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return index != GetSize() && !comp_(key, keys_[index]) ? index : GetSize();
+    }
+
+    size_t CheckedIndex(const Key& key) const {
+        const size_t index = FindIndex(key);
+        if(index == GetSize()) {
+            using namespace std::literals;
+            throw std::out_of_range("Key is not found in FlatMap"s);
+        }
+        return index;
+    }
+
+    Iterator Emplace(const Key& key) {
+        const size_t index = LowerBoundIndex(key);
+        if(index != GetSize() && !comp_(key, keys_[index])) {
+            return Iterator(this, index);
+        }
+        return InsertAt(index, key, Value());
+    }
+
+    // Вставляет запись в позицию index; если вставка значения не удалась, ключ убирается
+    Iterator InsertAt(size_t index, Key key, Value value) {
+        keys_.Insert(keys_.cbegin() + index, std::move(key));
+        try {
+            values_.Insert(values_.cbegin() + index, std::move(value));
+        } catch(...) {
+            keys_.Erase(keys_.cbegin() + index);
+            throw;
+        }
+        return Iterator(this, index);
+    }
+
+    void EraseAt(size_t index) {
+        keys_.Erase(keys_.cbegin() + index);
+        values_.Erase(values_.cbegin() + index);
+    }
+
+    // Упорядочивает записи, начиная с old_size, через перестановку индексов (ключи и значения
+    // лежат в разных массивах), удаляет среди них повторы ключей и сливает с упорядоченным
+    // префиксом в новые массивы. Элементы переносятся move_if_noexcept, поэтому при
+    // исключении префикс не портится
+    void MergeTail(size_t old_size) {
+        SimpleVector<size_t> order(GetSize() - old_size);
+        std::iota(order.begin(), order.end(), old_size);
+        std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return comp_(keys_[lhs], keys_[rhs]);
+        });
+        order.EraseRange(std::unique(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return !comp_(keys_[lhs], keys_[rhs]);
+        }), order.end());
+
+        // Добавленные записи уже упорядочены, различны и больше имеющихся: переставлять нечего
+        const bool in_place = order.GetSize() == GetSize() - old_size
+                              && std::is_sorted(order.begin(), order.end())
+                              && (old_size == 0 || order.IsEmpty() || comp_(keys_[old_size - 1], keys_[order[0]]));
+        if(in_place) {
+            return;
+        }
+
+        KeySequence keys(::Reserve(old_size + order.GetSize()));
+        ValueSequence values(::Reserve(old_size + order.GetSize()));
+        auto take = [&](size_t index) {
+            keys.PushBack(std::move_if_noexcept(keys_[index]));
+            values.PushBack(std::move_if_noexcept(values_[index]));
+        };
+        size_t left = 0;
+        size_t right = 0;
+        while(left < old_size && right < order.GetSize()) {
+            if(comp_(keys_[order[right]], keys_[left])) {
+                take(order[right++]);
+            } else {
+                right += comp_(keys_[left], keys_[order[right]]) ? 0 : 1;
+                take(left++);
+            }
+        }
+        for(; left < old_size; ++left) {
+            take(left);
+        }
+        for(; right < order.GetSize(); ++right) {
+            take(order[right]);
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+    }
+
+    KeySequence keys_;
+    ValueSequence values_;
+    Compare comp_;
+};
+
+template <typename Key, typename Value, typename Compare>
+bool operator==(const FlatMap<Key, Value, Compare>& lhs, const FlatMap<Key, Value, Compare>& rhs) {
+    return lhs.Keys() == rhs.Keys() && lhs.Values() == rhs.Values();
+}
+
+template <typename Key, typename Value, typename Compare>
+bool operator!=(const FlatMap<Key, Value, Compare>& lhs, const FlatMap<Key, Value, Compare>& rhs) {
+    return !(lhs == rhs);
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+namespace flat_detail {
+
+// Возвращает первый элемент [first, first + size), на котором pred ложен
+// (pred истинен на префиксе и ложен на остатке). Половина выбирается условной
+// пересылкой, а не переходом, поэтому шаг поиска не зависит от предсказателя ветвлений;
+// обе возможные следующие середины подгружаются в кеш заранее
+template <typename Type, typename Pred>
+const Type* PartitionPoint(const Type* first, size_t size, Pred pred) {
+    if(size == 0) {
+        return first;
+    }
+    while(size > 1) {
+        const size_t half = size / 2;
+#if defined(__GNUC__)
+        __builtin_prefetch(first + half / 2);
+        __builtin_prefetch(first + half + half / 2);
+#endif
+        first = pred(first[half]) ? first + half : first;
+        size -= half;
+    }
+    return first + (pred(*first) ? 1 : 0);
+}
+
+template <typename Type, typename Key, typename Compare>
+const Type* LowerBound(const Type* first, size_t size, const Key& key, const Compare& comp) {
+    return PartitionPoint(first, size, [&](const Type& item) {
+        return comp(item, key);
+    });
+}
+
+template <typename Type, typename Key, typename Compare>
+const Type* UpperBound(const Type* first, size_t size, const Key& key, const Compare& comp) {
+    return PartitionPoint(first, size, [&](const Type& item) {
+        return !comp(key, item);
+    });
+}
+
+// Проверяет, что [first, last) строго возрастает
+template <typename It, typename Compare>
+bool IsStrictlySorted(It first, It last, const Compare& comp) {
+    return std::adjacent_find(first, last, [&](const auto& lhs, const auto& rhs) {
+        return !comp(lhs, rhs);
+    }) == last;
+}
+
+} // namespace flat_detail
+
+// Упорядоченное множество в непрерывном отсортированном SimpleVector.
+// Поиск - двоичный без ветвлений по непрерывной памяти, вставка одного ключа - сдвиг O(n),
+// поэтому много ключей стоит добавлять через InsertMany: они дописываются в конец,
+// сортируются и сливаются с имеющимися за один проход.
+// ExtractSequence и AdoptSequence передают хранилище без копирования
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet {
+public:
+    // Ключи нельзя менять на месте: это нарушило бы порядок
+    using Iterator = const Key*;
+    using ConstIterator = const Key*;
+    using Sequence = SimpleVector<Key>;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertMany(init.begin(), init.end());
+    }
+
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertMany(first, last);
+    }
+
+    // Забирает последовательность без копирования, сортирует её на месте и удаляет повторы
+    explicit FlatSet(Sequence&& sequence, const Compare& comp = Compare())
+        : keys_(std::move(sequence)), comp_(comp) {
+        MergeTail(0);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    ConstIterator begin() const noexcept {
+        return keys_.begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return keys_.end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+
+    // Первый ключ, не меньший key
+    ConstIterator LowerBound(const Key& key) const {
+        return flat_detail::LowerBound(keys_.cbegin(), keys_.GetSize(), key, comp_);
+    }
+
+    // Первый ключ, больший key
+    ConstIterator UpperBound(const Key& key) const {
+        return flat_detail::UpperBound(keys_.cbegin(), keys_.GetSize(), key, comp_);
+    }
+
+    ConstIterator Find(const Key& key) const {
+        const ConstIterator it = LowerBound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Вставляет ключ, если его нет. Возвращает итератор на ключ и признак вставки
+    std::pair<ConstIterator, bool> Insert(Key key) {
+        const ConstIterator it = LowerBound(key);
+        if(it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.Insert(it, std::move(key)), true};
+    }
+
+    // Дописывает ключи [first, last) в конец, сортирует их и сливает с имеющимися
+    // за один проход: O(n + m log m) вместо O(n * m) для вставки по одному.
+    // Из равных ключей остаётся уже имевшийся или первый из добавленных
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void InsertMany(InputIt first, InputIt last) {
+        const size_t old_size = keys_.GetSize();
+        try {
+            keys_.Append(first, last);
+            MergeTail(old_size);
+        } catch(...) {
+            keys_.EraseRange(keys_.begin() + old_size, keys_.end());
+            throw;
+        }
+    }
+
+    // Удаляет ключ, возвращает количество удалённых (0 или 1)
+    size_t Erase(const Key& key) {
+        const ConstIterator it = Find(key);
+        if(it == end()) {
+            return 0;
+        }
+        keys_.Erase(it);
+        return 1;
+    }
+
+    ConstIterator Erase(ConstIterator pos) {
+        return keys_.Erase(pos);
+    }
+
+    // Отдаёт отсортированную последовательность ключей без копирования, множество становится пустым
+    Sequence ExtractSequence() noexcept {
+        Sequence result;
+        result.swap(keys_);
+        return result;
+    }
+
+    // Забирает последовательность без копирования. Она должна быть строго упорядочена по Compare
+    void AdoptSequence(Sequence&& sequence) noexcept {
+        assert(flat_detail::IsStrictlySorted(sequence.begin(), sequence.end(), comp_));
+        Sequence(std::move(sequence)).swap(keys_);
+    }
+
+    const Sequence& GetSequence() const noexcept {
+        return keys_;
+    }
+
+    void swap(FlatSet& other) noexcept {
+        keys_.swap(other.keys_);
+        std::swap(comp_, other.comp_);
+    }
+
+private:
+    // Сортирует ключи, начиная с old_size, удаляет среди них повторы и сливает
+    // с упорядоченным префиксом. Слияние идёт в новый буфер; элементы переносятся
+    // move_if_noexcept, поэтому при исключении префикс не портится
+    void MergeTail(size_t old_size) {
+        Key* tail = keys_.begin() + old_size;
+        std::stable_sort(tail, keys_.end(), comp_);
+        Key* tail_end = std::unique(tail, keys_.end(), [&](const Key& lhs, const Key& rhs) {
+            return !comp_(lhs, rhs);
+        });
+        keys_.EraseRange(tail_end, keys_.end());
+        if(old_size == 0 || old_size == keys_.GetSize() || comp_(keys_[old_size - 1], keys_[old_size])) {
+            return;
+        }
+        Sequence merged(::Reserve(keys_.GetSize()));
+        size_t left = 0;
+        size_t right = old_size;
+        while(left < old_size && right < keys_.GetSize()) {
+            if(comp_(keys_[right], keys_[left])) {
+                merged.PushBack(std::move_if_noexcept(keys_[right++]));
+            } else {
+                right += comp_(keys_[left], keys_[right]) ? 0 : 1;
+                merged.PushBack(std::move_if_noexcept(keys_[left++]));
+            }
+        }
+        for(; left < old_size; ++left) {
+            merged.PushBack(std::move_if_noexcept(keys_[left]));
+        }
+        for(; right < keys_.GetSize(); ++right) {
+            merged.PushBack(std::move_if_noexcept(keys_[right]));
+        }
+        keys_.swap(merged);
+    }
+
+    Sequence keys_;
+    Compare comp_;
+};
+
+template <typename Key, typename Compare>
+bool operator==(const FlatSet<Key, Compare>& lhs, const FlatSet<Key, Compare>& rhs) {
+    return lhs.GetSequence() == rhs.GetSequence();
+}
+
+template <typename Key, typename Compare>
+bool operator!=(const FlatSet<Key, Compare>& lhs, const FlatSet<Key, Compare>& rhs) {
+    return !(lhs == rhs);
+}
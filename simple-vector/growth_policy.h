@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#ifdef SIMPLE_VECTOR_USE_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif
+
+// Политики роста вместимости SimpleVector.
+// NextCapacity получает текущую вместимость, требуемое число элементов и размер элемента
+// и возвращает новую вместимость, не меньшую required.
+
+// Рост вдвое: меньше всего перевыделений, но освобождённые блоки
+// никогда не подходят для следующего шага роста
+struct DoublingGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity * 2, required);
+    }
+};
+
+// Рост в полтора раза: после нескольких шагов сумма освобождённых блоков
+// превышает новый запрос, и аллокатор может переиспользовать память
+struct HalfGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity + capacity / 2, required);
+    }
+};
+
+// Рост в 1.6 раза - чуть меньше золотого сечения, самого большого множителя,
+// при котором освобождённые блоки ещё могут быть переиспользованы
+struct GoldenRatioGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity + capacity / 2 + capacity / 10, required);
+    }
+};
+
+// Возвращает, сколько байт аллокатор на самом деле отдаст на запрос bytes.
+// С jemalloc (SIMPLE_VECTOR_USE_JEMALLOC) размер класса спрашивается у nallocx,
+// для glibc повторяются её правила округления, иначе запрос не меняется
+inline size_t UsableAllocationSize(size_t bytes) noexcept {
+#if defined(SIMPLE_VECTOR_USE_JEMALLOC)
+    return bytes == 0 ? 0 : nallocx(bytes, 0);
+#elif defined(__GLIBC__)
+    constexpr size_t kHeader = sizeof(size_t);
+    constexpr size_t kAlignment = 2 * sizeof(size_t);
+    constexpr size_t kMinChunk = 4 * sizeof(size_t);
+    // Порог mmap по умолчанию: большие блоки выделяются целыми страницами
+    constexpr size_t kMmapThreshold = 128 * 1024;
+    constexpr size_t kPage = 4096;
+    if(bytes == 0 || bytes > std::numeric_limits<size_t>::max() - kMmapThreshold) {
+        return bytes;
+    }
+    if(bytes >= kMmapThreshold) {
+        return (bytes + 2 * kHeader + kPage - 1) / kPage * kPage - 2 * kHeader;
+    }
+    const size_t chunk = std::max(kMinChunk, (bytes + kHeader + kAlignment - 1) / kAlignment * kAlignment);
+    return chunk - kHeader;
+#else
+    return bytes;
+#endif
+}
+
+// Рост вдвое с округлением до класса размеров аллокатора: хвост блока,
+// который аллокатор всё равно выделит, становится доступной вместимостью
+template <typename BaseGrowth = DoublingGrowth>
+struct AllocatorSizeClassGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t capacity_hint = BaseGrowth::NextCapacity(capacity, required, element_size);
+        if(capacity_hint > std::numeric_limits<size_t>::max() / element_size) {
+            return capacity_hint;
+        }
+        return std::max(capacity_hint, UsableAllocationSize(capacity_hint * element_size) / element_size);
+    }
+};
@@ -1,36 +1,113 @@
 #include "simple_vector.h"
+#include "parallel_algorithms.h"
+#include "concurrent_simple_vector.h"
+#include "mapped_simple_vector.h"
+#include "simple_vector_io.h"
+#include "soa_simple_vector.h"
+#include "shared_simple_vector.h"
+#include "persistent_simple_vector.h"
+#include "static_simple_vector.h"
+#include "flat_map.h"
+#include "aligned_allocator.h"
+#include "simple_deque.h"
+#include "simple_vector_view.h"
+#include "test_types.h"
 
+#include <atomic>
 #include <cassert>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
 
 using namespace std;
 
-class X {
+// Считает живые объекты, чтобы проверять, что вектор не создаёт лишних элементов
+class Counted {
 public:
-    X()
-            : X(5) {
+    explicit Counted(int value = 0)
+            : value_(value) {
+        ++alive;
     }
-    X(size_t num)
-            : x_(num) {
+    Counted(const Counted& other)
+            : value_(other.value_) {
+        ++alive;
     }
-    X(const X& other) = delete;
-    X& operator=(const X& other) = delete;
-    X(X&& other) {
-        x_ = exchange(other.x_, 0);
+    Counted(Counted&& other) noexcept
+            : value_(other.value_) {
+        ++alive;
     }
-    X& operator=(X&& other) {
-        x_ = exchange(other.x_, 0);
-        return *this;
+    Counted& operator=(const Counted& other) = default;
+    Counted& operator=(Counted&& other) noexcept = default;
+    ~Counted() {
+        --alive;
     }
-    size_t GetX() const {
-        return x_;
+    int GetValue() const {
+        return value_;
     }
 
+    static inline int alive = 0;
+
 private:
-    size_t x_;
+    int value_;
 };
 
+// Владеет памятью в куче, но переносится побайтово: включает быстрый путь явно
+// Счётчик живых объектов для параллельного создания; бросает исключение на kThrowAt-й копии
+struct AtomicCounted {
+    static constexpr int kThrowAt = 600'000;
+
+    AtomicCounted() {
+        ++alive;
+    }
+    AtomicCounted(const AtomicCounted&) {
+        if(++copies == kThrowAt) {
+            throw runtime_error("copy");
+        }
+        ++alive;
+    }
+    ~AtomicCounted() {
+        --alive;
+    }
+
+    static inline atomic<int> alive = 0;
+    static inline atomic<int> copies = 0;
+};
+
+struct Boxed {
+    unique_ptr<int> value;
+};
+
+template <>
+struct IsTriviallyRelocatable<Boxed> : std::true_type {};
+
+// Переносится побайтово, но перемещающий конструктор может бросить исключение
+struct ThrowingRelocatable {
+    ThrowingRelocatable(int v)
+        : value(v) {
+    }
+    ThrowingRelocatable(ThrowingRelocatable&& other)
+        : value(other.value) {
+        if(fail) {
+            throw runtime_error("move");
+        }
+    }
+    ThrowingRelocatable& operator=(ThrowingRelocatable&&) = default;
+
+    int value;
+    static inline bool fail = false;
+};
+
+template <>
+struct IsTriviallyRelocatable<ThrowingRelocatable> : std::true_type {};
+
 SimpleVector<int> GenerateVector(size_t size) {
     SimpleVector<int> v(size);
     iota(v.begin(), v.end(), 1);
@@ -144,11 +221,1292 @@ void TestNoncopiableErase() {
         v.PushBack(X(i));
     }
 
-    auto it = v.Erase(v.begin());
+    [[maybe_unused]] auto it = v.Erase(v.begin());
     assert(it->GetX() == 1);
     cout << "Done!" << endl << endl;
 }
 
+void TestUninitializedCapacity() {
+    cout << "Test capacity does not construct elements" << endl;
+    {
+        SimpleVector<Counted> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(Counted(i));
+        }
+        assert(v.GetCapacity() > v.GetSize());
+        assert(Counted::alive == 100);
+
+        v.Reserve(1000);
+        assert(Counted::alive == 100);
+        v.Resize(10);
+        assert(Counted::alive == 10);
+        v.Erase(v.begin());
+        assert(Counted::alive == 9 && v[0].GetValue() == 1);
+        v.PopBack();
+        assert(Counted::alive == 8);
+        v.Insert(v.begin() + 2, Counted(42));
+        assert(Counted::alive == 9 && v[2].GetValue() == 42 && v[3].GetValue() == 3);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestEmplace() {
+    cout << "Test emplace" << endl;
+    struct Point {
+        int x;
+        int y;
+    };
+    SimpleVector<Point> points;
+    [[maybe_unused]] Point& p = points.EmplaceBack(1, 2);
+    assert(p.x == 1 && p.y == 2);
+    [[maybe_unused]] auto it = points.Emplace(points.begin(), 3, 4);
+    assert(it == points.begin() && it->x == 3 && points[1].y == 2);
+
+    // Ссылка на собственный элемент должна пережить перевыделение
+    SimpleVector<string> v;
+    v.EmplaceBack(30, 'a');
+    assert(v.GetSize() == v.GetCapacity());
+    v.EmplaceBack(v[0]);
+    assert(v[1] == string(30, 'a'));
+    v.EmplaceBack(40, 'b');
+    v.Reserve(v.GetSize());
+    v.Resize(v.GetCapacity());
+    v.Emplace(v.begin(), v[2]);
+    assert(v[0] == string(40, 'b') && v[3] == string(40, 'b'));
+    v.Emplace(v.begin() + 1, v[3]);
+    assert(v[1] == string(40, 'b') && v[4] == string(40, 'b'));
+    cout << "Done!" << endl << endl;
+}
+
+void TestMoveIsCheap() {
+    cout << "Test move operations steal the buffer" << endl;
+    static_assert(is_nothrow_move_constructible_v<SimpleVector<int>>);
+    static_assert(is_nothrow_move_assignable_v<SimpleVector<int>>);
+    static_assert(is_nothrow_swappable_v<SimpleVector<int>>);
+
+    SimpleVector<X> source;
+    source.PushBack(X(7));
+    [[maybe_unused]] const X* data = source.begin();
+    SimpleVector<X> target;
+    target = move(source);
+    assert(target.begin() == data && target[0].GetX() == 7);
+    assert(source.GetSize() == 0 && source.GetCapacity() == 0);
+
+    // Вложенные векторы при росте перемещаются, а не копируются
+    SimpleVector<SimpleVector<int>> nested;
+    nested.PushBack(GenerateVector(10));
+    [[maybe_unused]] const int* inner = nested[0].begin();
+    for (int i = 0; i < 10; ++i) {
+        nested.PushBack(SimpleVector<int>());
+    }
+    assert(nested[0].begin() == inner);
+    cout << "Done!" << endl << endl;
+}
+
+void TestTriviallyRelocatable() {
+    cout << "Test trivially relocatable fast path" << endl;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(!IsTriviallyRelocatableV<string>);
+
+    SimpleVector<int> numbers;
+    for (int i = 0; i < 100; ++i) {
+        numbers.PushBack(i);
+    }
+    numbers.Insert(numbers.begin(), -1);
+    numbers.Insert(numbers.begin() + 50, -2);
+    assert(numbers.GetSize() == 102 && numbers[0] == -1 && numbers[1] == 0);
+    assert(numbers[50] == -2 && numbers[51] == 49 && numbers[101] == 99);
+    numbers.Erase(numbers.begin() + 50);
+    numbers.Erase(numbers.begin());
+    for (int i = 0; i < 100; ++i) {
+        assert(numbers[i] == i);
+    }
+
+    SimpleVector<Boxed> boxes;
+    for (int i = 0; i < 20; ++i) {
+        boxes.PushBack(Boxed{make_unique<int>(i)});
+    }
+    boxes.Insert(boxes.begin() + 3, Boxed{make_unique<int>(100)});
+    boxes.Erase(boxes.begin());
+    assert(*boxes[0].value == 1 && *boxes[2].value == 100 && *boxes[3].value == 3);
+    assert(boxes.GetSize() == 20);
+
+    // Исключение при перемещении вставляемого значения возвращает хвост на место
+    SimpleVector<ThrowingRelocatable> relocatable(Reserve(8));
+    for (int i = 0; i < 4; ++i) {
+        relocatable.EmplaceBack(i);
+    }
+    ThrowingRelocatable::fail = true;
+    try {
+        relocatable.Emplace(relocatable.begin() + 1, 100);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    ThrowingRelocatable::fail = false;
+    assert(relocatable.GetSize() == 4);
+    for (int i = 0; i < 4; ++i) {
+        assert(relocatable[i].value == i);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestPmrAllocator() {
+    cout << "Test polymorphic allocator" << endl;
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+        ::pmr::SimpleVector<int> numbers(&arena);
+        for (int i = 0; i < 100; ++i) {
+            numbers.PushBack(i);
+        }
+        assert(numbers.GetAllocator().resource() == &arena);
+        assert(numbers.begin() >= reinterpret_cast<int*>(buffer) && numbers.end() <= reinterpret_cast<int*>(buffer + sizeof(buffer)));
+
+        // Копия берёт ресурс по умолчанию, а не арену
+        ::pmr::SimpleVector<int> copy(numbers);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        assert(copy == numbers);
+
+        // Аллокатор не переезжает при перемещении, элементы переносятся в арену поштучно
+        numbers = move(copy);
+        assert(numbers.GetAllocator().resource() == &arena);
+        assert(numbers.GetSize() == 100 && numbers[99] == 99);
+
+        ::pmr::SimpleVector<string> strings(&arena);
+        strings.EmplaceBack(50, 'x');
+        strings.Insert(strings.begin(), string(40, 'y'));
+        assert(strings[0] == string(40, 'y') && strings[1] == string(50, 'x'));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSmallVector() {
+    cout << "Test small vector" << endl;
+    SmallSimpleVector<string, 4> v;
+    assert(v.IsInline() && v.GetCapacity() == 4);
+    const char* object_begin = reinterpret_cast<const char*>(&v);
+    [[maybe_unused]] const char* object_end = object_begin + sizeof(v);
+    for (int i = 0; i < 4; ++i) {
+        v.PushBack(to_string(i));
+    }
+    assert(v.IsInline());
+    assert(reinterpret_cast<const char*>(v.begin()) >= object_begin && reinterpret_cast<const char*>(v.end()) <= object_end);
+
+    // Встроенный вектор перемещается поштучно
+    SmallSimpleVector<string, 4> moved(move(v));
+    assert(moved.IsInline() && moved.GetSize() == 4 && moved[3] == "3"s);
+    assert(v.IsEmpty());
+
+    // Переполнение переносит элементы в кучу, аргумент может ссылаться на сам вектор
+    moved.EmplaceBack(moved[0]);
+    assert(!moved.IsInline() && moved.GetSize() == 5 && moved[4] == "0"s);
+    moved.Insert(moved.begin(), "front"s);
+    moved.Erase(moved.begin() + 1);
+    assert(moved[0] == "front"s && moved[1] == "1"s);
+
+    // Вектор в куче перемещается без копирования буфера
+    [[maybe_unused]] const string* data = moved.begin();
+    v = move(moved);
+    assert(v.begin() == data && moved.IsInline() && moved.IsEmpty());
+
+    SmallSimpleVector<string, 4> copy(v);
+    assert(copy == v && !(copy < v) && copy <= v);
+    copy.Resize(2);
+    assert(copy.GetSize() == 2 && copy < v);
+    copy.swap(v);
+    assert(copy.GetSize() == 5 && v.GetSize() == 2);
+
+    // Присваивание встроенного вектора вектору в куче возвращает вместимость N
+    SmallSimpleVector<int, 4> heap_backed;
+    for (int i = 0; i < 100; ++i) {
+        heap_backed.PushBack(i);
+    }
+    SmallSimpleVector<int, 4> small{7};
+    heap_backed = move(small);
+    assert(heap_backed.IsInline() && heap_backed.GetCapacity() == 4 && heap_backed[0] == 7);
+    for (int i = 0; i < 10; ++i) {
+        heap_backed.PushBack(i);
+    }
+    assert(!heap_backed.IsInline() && heap_backed.GetSize() == 11 && heap_backed[10] == 9);
+    SmallSimpleVector<int, 4> inline_copy{1, 2};
+    heap_backed = inline_copy;
+    assert(heap_backed.IsInline() && heap_backed.GetCapacity() == 4);
+    heap_backed.PushBack(3);
+    heap_backed.PushBack(4);
+    heap_backed.PushBack(5);
+    assert(!heap_backed.IsInline() && heap_backed[4] == 5);
+
+    SmallSimpleVector<X, 2> noncopyable;
+    for (size_t i = 0; i < 5; ++i) {
+        noncopyable.PushBack(X(i));
+    }
+    assert(noncopyable[4].GetX() == 4);
+    cout << "Done!" << endl << endl;
+}
+
+void TestGrowthPolicy() {
+    cout << "Test growth policies" << endl;
+    assert(DoublingGrowth::NextCapacity(8, 9, 4) == 16);
+    assert(HalfGrowth::NextCapacity(8, 9, 4) == 12);
+    assert(GoldenRatioGrowth::NextCapacity(10, 11, 4) == 16);
+    assert(HalfGrowth::NextCapacity(0, 1, 4) == 1);
+    assert(AllocatorSizeClassGrowth<>::NextCapacity(8, 9, 4) >= 16);
+
+    SimpleVector<int, allocator<int>, HalfGrowth> v;
+    size_t reallocations = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const size_t capacity = v.GetCapacity();
+        v.PushBack(i);
+        if (v.GetCapacity() != capacity) {
+            assert(capacity < 2 || v.GetCapacity() == capacity + capacity / 2);
+            ++reallocations;
+        }
+    }
+    assert(reallocations > 10);
+
+    SimpleVector<int, allocator<int>, AllocatorSizeClassGrowth<>> sized;
+    sized.PushBack(1);
+    assert(sized.GetCapacity() >= 1);
+
+    v.Resize(10);
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 10 && v[9] == 9);
+    v.Clear();
+    v.ShrinkToFit();
+    assert(v.GetCapacity() == 0 && v.begin() == nullptr);
+    cout << "Done!" << endl << endl;
+}
+
+void TestRangeOperations() {
+    cout << "Test range operations" << endl;
+    const list<string> words = {"a"s, "b"s, "c"s, "d"s};
+    SimpleVector<string> v(words.begin(), words.end());
+    assert(v.GetSize() == 4 && v.GetCapacity() == 4 && v[3] == "d"s);
+
+    // Вставка короче хвоста и длиннее хвоста без перевыделения
+    v.Reserve(20);
+    v.InsertRange(v.begin() + 1, words.begin(), next(words.begin(), 2));
+    assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "b"s, "c"s, "d"s}));
+    v.InsertRange(v.begin() + 5, words.begin(), words.end());
+    assert((v == SimpleVector<string>{"a"s, "a"s, "b"s, "b"s, "c"s, "a"s, "b"s, "c"s, "d"s, "d"s}));
+    assert(v.GetCapacity() == 20);
+
+    // Вставка с перевыделением
+    SimpleVector<string> copy(v.begin(), v.end());
+    v.InsertRange(v.begin(), copy.begin(), copy.end());
+    v.Append(words.begin(), words.end());
+    assert(v.GetSize() == 24 && v[0] == "a"s && v[10] == "a"s && v[23] == "d"s);
+
+    v.EraseRange(v.begin(), v.begin() + 10);
+    assert(v.GetSize() == 14 && v[0] == "a"s && v[9] == "d"s);
+    v.AssignRange(words.begin(), words.end());
+    assert(v.GetSize() == 4 && v[1] == "b"s);
+
+    // Однопроходные итераторы
+    istringstream input("1 2 3 4 5");
+    SimpleVector<int> numbers = {10, 20};
+    numbers.InsertRange(numbers.begin() + 1, istream_iterator<int>(input), istream_iterator<int>());
+    assert((numbers == SimpleVector<int>{10, 1, 2, 3, 4, 5, 20}));
+    numbers.EraseRange(numbers.begin() + 1, numbers.end() - 1);
+    assert((numbers == SimpleVector<int>{10, 20}));
+    cout << "Done!" << endl << endl;
+}
+
+void TestStats() {
+    cout << "Test stats" << endl;
+    {
+        SIMPLE_VECTOR_STATS_SCOPE("TestStats");
+        SimpleVector<double> v;
+        for(int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        v.Reserve(100);
+    }
+    [[maybe_unused]] const SimpleVectorStats stats = GetSimpleVectorStats<SimpleVector<double>>();
+#ifdef SIMPLE_VECTOR_ENABLE_STATS
+    // Вместимость растёт 1 -> 2 -> 4 -> 8, затем Reserve(100)
+    assert(stats.allocations == 5);
+    assert(stats.reallocations == 4);
+    assert(stats.elements_relocated == 1 + 2 + 4 + 5);
+    assert(stats.bytes_relocated == stats.elements_relocated * sizeof(double));
+    assert(stats.peak_capacity == 100);
+    assert(stats.unused_bytes_released == 95 * sizeof(double));
+    const auto sites = GetSimpleVectorSiteStats();
+    assert(sites.size() == 1 && sites[0].first == "TestStats"s);
+    assert(sites[0].second.allocations == 5 && sites[0].second.peak_capacity == 100);
+
+    // ShrinkToFit засчитывает отпущенную лишнюю вместимость, в том числе при освобождении всего буфера
+    {
+        SimpleVector<float> shrunk(Reserve(10));
+        shrunk.PushBack(1.0f);
+        shrunk.PushBack(2.0f);
+        shrunk.PushBack(3.0f);
+        shrunk.ShrinkToFit();
+        assert(GetSimpleVectorStats<SimpleVector<float>>().unused_bytes_released == 7 * sizeof(float));
+        shrunk.Clear();
+        shrunk.ShrinkToFit();
+    }
+    assert(GetSimpleVectorStats<SimpleVector<float>>().unused_bytes_released == 10 * sizeof(float));
+#else
+    assert(stats.allocations == 0 && GetSimpleVectorSiteStats().empty());
+#endif
+    cout << "Done!" << endl << endl;
+}
+
+void TestSimdKernels() {
+    cout << "Test simd kernels" << endl;
+    // Длины подобраны так, чтобы задеть и векторные блоки, и хвост
+    SimpleVector<int> a(1003);
+    iota(a.begin(), a.end(), -500);
+    SimpleVector<int> b = a;
+    assert(a == b && a <= b && a >= b && !(a < b));
+    b[700] = 1000;
+    assert(a != b && a < b && a <= b && b > a && b >= a);
+    b.PopBack();
+    assert(b > a);
+
+    assert(a.Find(0) == a.begin() + 500 && a.Find(100500) == a.end());
+    assert(a.Count(7) == 1 && b.Count(1000) == 1);
+    assert(a.Min() == -500 && a.Max() == 502 && a.Sum() == 1003);
+
+    SimpleVector<uint8_t> bytes(1000, 3);
+    bytes[999] = 200;
+    assert(bytes.Count(3) == 999 && bytes.Max() == 200 && bytes.Sum() == static_cast<uint8_t>(999 * 3 + 200));
+
+    // Неарифметические типы идут обычными циклами
+    SimpleVector<string> words = {"b"s, "a"s, "c"s};
+    assert(words.Find("a"s) == words.begin() + 1 && words.Min() == "a"s && words.Max() == "c"s);
+    assert((words < SimpleVector<string>{"b"s, "b"s}));
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+    assert((a <=> b) == std::strong_ordering::less);
+    assert((words <=> words) == 0);
+#endif
+    cout << "Done!" << endl << endl;
+}
+
+void TestParallelAlgorithms() {
+    cout << "Test parallel algorithms" << endl;
+    ThreadPool pool(3);
+    // Достаточно элементов, чтобы работа разбилась на несколько кусков
+    const size_t size = 1'000'003;
+    SimpleVector<int> filled(Parallel(pool), size, 7);
+    assert(filled.GetSize() == size && filled.Count(7) == size);
+
+    SimpleVector<int> numbers(Parallel(pool), size);
+    assert(numbers.Count(0) == size);
+    ParallelTransform(filled, numbers, [](int value) {
+        return value * 2;
+    }, Parallel(pool));
+    assert(numbers.Count(14) == size);
+    iota(numbers.begin(), numbers.end(), 0);
+    assert(ParallelReduce(numbers, int64_t{0}, plus<>(), Parallel(pool)) == int64_t{size} * (size - 1) / 2);
+
+    SimpleVector<int> copy(Parallel(pool), numbers);
+    assert(copy == numbers);
+    reverse(copy.begin(), copy.end());
+    ParallelSort(copy, less<>(), Parallel(pool));
+    assert(copy == numbers);
+    ParallelSort(copy, greater<>(), Parallel(pool));
+    assert(copy.Max() == copy[0] && is_sorted(copy.begin(), copy.end(), greater<>()));
+
+    copy.Resize(Parallel(pool), 2 * size);
+    assert(copy.GetSize() == 2 * size && copy.Count(0) == size + 1);
+
+    // Исключение в одном из кусков: созданные элементы разрушаются, исключение доходит до вызывающего
+    [[maybe_unused]] bool thrown = false;
+    try {
+        SimpleVector<AtomicCounted> failed(Parallel(pool), size, AtomicCounted());
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && AtomicCounted::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestConcurrentVector() {
+    cout << "Test concurrent vector" << endl;
+    ConcurrentSimpleVector<int> v;
+    [[maybe_unused]] const int* first = &v.PushBack(-1);
+    const int threads = 4;
+    const int per_thread = 50'000;
+    vector<thread> producers;
+    for(int t = 0; t < threads; ++t) {
+        producers.emplace_back([&v, t] {
+            for(int i = 0; i < per_thread; ++i) {
+                v.EmplaceBack(t * per_thread + i);
+            }
+        });
+    }
+    // Читатель видит только созданные элементы
+    thread reader([&v] {
+        size_t seen = 0;
+        while(seen <= threads * per_thread) {
+            const size_t size = v.GetSize();
+            for(; seen < size; ++seen) {
+                assert(v[seen] >= -1 && v[seen] < threads * per_thread);
+            }
+        }
+    });
+    for(thread& producer : producers) {
+        producer.join();
+    }
+    reader.join();
+    // Элементы не переезжают
+    assert(first == &v[0] && *first == -1);
+    assert(v.GetSize() == threads * per_thread + 1);
+
+    SimpleVector<int> values = v.ToSimpleVector();
+    sort(values.begin(), values.end());
+    for(int i = 0; i <= threads * per_thread; ++i) {
+        assert(values[i] == i - 1);
+    }
+
+    ConcurrentSimpleVector<string> words;
+    words.Reserve(100);
+    assert(words.GetCapacity() >= 100 && words.IsEmpty());
+    words.PushBack("a"s);
+    assert(words.At(0) == "a"s);
+    try {
+        words.At(1);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+    words.Clear();
+    assert(words.GetSize() == 0);
+
+    // Сегмент под такие элементы не выделить: исключение до занятия ячейки, вектор не меняется
+    struct Oversized {
+        char bytes[size_t{1} << 59];
+    };
+    ConcurrentSimpleVector<Oversized> oversized;
+    for(int attempt = 0; attempt < 2; ++attempt) {
+        try {
+            oversized.EmplaceBack();
+            assert(false);
+        } catch(const bad_alloc&) {
+        }
+        assert(oversized.IsEmpty() && oversized.GetCapacity() == 0);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestMappedVector() {
+    cout << "Test mapped vector" << endl;
+    const string path = (filesystem::temp_directory_path() / "simple_vector_mapped_test.bin").string();
+    struct Point {
+        int32_t x;
+        int32_t y;
+    };
+    {
+        auto points = MappedSimpleVector<Point>::Create(path);
+        assert(points.IsEmpty() && points.GetCapacity() == 0);
+        for(int i = 0; i < 1000; ++i) {
+            points.EmplaceBack(i, -i);
+        }
+        assert(points.GetSize() == 1000 && points.GetCapacity() >= 1000);
+        points.Resize(1010);
+        assert(points[1009].x == 0 && points[999].y == -999);
+        points.Sync();
+    }
+    {
+        const auto points = MappedSimpleVector<Point>::OpenReadOnly(path);
+        assert(points.IsReadOnly() && points.GetSize() == 1010);
+        assert(points[500].x == 500 && points.At(999).y == -999);
+        [[maybe_unused]] bool thrown = false;
+        try {
+            auto writable = MappedSimpleVector<Point>::OpenReadOnly(path);
+            writable.PushBack({1, 1});
+        } catch(const logic_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        auto points = MappedSimpleVector<Point>::Open(path);
+        points.PopBack();
+        points[0].x = 42;
+
+        // Перемещённый вектор закрыт и пуст
+        auto moved = move(points);
+        assert(moved.IsOpen() && moved.GetSize() == 1009);
+        assert(!points.IsOpen() && points.IsEmpty() && points.GetCapacity() == 0);
+        assert(points.begin() == points.end());
+        points.Sync();
+        [[maybe_unused]] bool closed_thrown = false;
+        try {
+            points.PushBack({1, 1});
+        } catch(const logic_error&) {
+            closed_thrown = true;
+        }
+        assert(closed_thrown);
+    }
+    assert(MappedSimpleVector<Point>::OpenReadOnly(path)[0].x == 42);
+    assert(MappedSimpleVector<Point>::OpenReadOnly(path).GetSize() == 1009);
+
+    // Файл с другим размером элемента не открывается
+    [[maybe_unused]] bool thrown = false;
+    try {
+        MappedSimpleVector<uint32_t>::OpenReadOnly(path);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    filesystem::remove(path);
+
+    thrown = false;
+    try {
+        MappedSimpleVector<uint64_t>::OpenReadOnly(path);
+    } catch(const system_error& error) {
+        thrown = error.code() == errc::no_such_file_or_directory;
+    }
+    assert(thrown);
+    cout << "Done!" << endl << endl;
+}
+
+void TestSerialization() {
+    cout << "Test serialization" << endl;
+    SimpleVector<uint64_t> numbers(10'000);
+    iota(numbers.begin(), numbers.end(), 1);
+
+    stringstream stream;
+    Serialize(numbers, stream);
+    Serialize(SimpleVector<uint64_t>(), stream);
+    assert(Deserialize<uint64_t>(stream) == numbers);
+    assert(Deserialize<uint64_t>(stream).IsEmpty());
+
+    // Через файловый дескриптор
+    FILE* file = tmpfile();
+    const int fd = fileno(file);
+    Serialize(numbers, fd);
+    lseek(fd, 0, SEEK_SET);
+    assert(Deserialize<uint64_t>(fd) == numbers);
+
+    // Ошибки формата
+    stringstream wrong_size;
+    Serialize(numbers, wrong_size);
+    [[maybe_unused]] bool thrown = false;
+    try {
+        Deserialize<uint32_t>(wrong_size);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    stringstream truncated(stream.str().substr(0, 100));
+    thrown = false;
+    try {
+        Deserialize<uint64_t>(truncated);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Испорченное количество в заголовке не приводит к огромному резервированию
+    const simple_vector_io::Header huge = simple_vector_io::MakeHeader<uint64_t>(size_t(1) << 60);
+    stringstream corrupt;
+    corrupt.write(reinterpret_cast<const char*>(&huge), sizeof(huge));
+    corrupt.write(reinterpret_cast<const char*>(numbers.cbegin()), 16);
+    thrown = false;
+    try {
+        Deserialize<uint64_t>(corrupt);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    FILE* corrupt_file = tmpfile();
+    const int corrupt_fd = fileno(corrupt_file);
+    [[maybe_unused]] const ssize_t header_written = write(corrupt_fd, &huge, sizeof(huge));
+    assert(header_written == static_cast<ssize_t>(sizeof(huge)));
+    lseek(corrupt_fd, 0, SEEK_SET);
+    thrown = false;
+    try {
+        Deserialize<uint64_t>(corrupt_fd);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    fclose(corrupt_file);
+
+    // Потоковый режим: сырые элементы без заголовка
+    lseek(fd, sizeof(simple_vector_io::Header), SEEK_SET);
+    SimpleVector<uint64_t> appended = {0};
+    assert(AppendFrom(appended, fd, 1000) == 10'000);
+    assert(appended.GetSize() == 10'001 && appended[10'000] == 10'000);
+
+    lseek(fd, sizeof(simple_vector_io::Header), SEEK_SET);
+    size_t batches = 0;
+    uint64_t sum = 0;
+    ForEachBatch<uint64_t>(fd, 3000, [&](const SimpleVector<uint64_t>& batch) {
+        assert(batch.GetSize() <= 3000);
+        ++batches;
+        sum += batch.Sum();
+    });
+    assert(batches == 4 && sum == numbers.Sum());
+
+    // Пакет нулевого размера отвергается сразу, а не читается бесконечно
+    thrown = false;
+    try {
+        AppendFrom(appended, fd, 0);
+    } catch(const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && appended.GetSize() == 10'001);
+    thrown = false;
+    try {
+        ForEachBatch<uint64_t>(fd, 0, [](const SimpleVector<uint64_t>&) {
+            assert(false);
+        });
+    } catch(const invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    fclose(file);
+
+    istringstream odd("12345");
+    SimpleVector<uint32_t> words;
+    thrown = false;
+    try {
+        AppendFrom(words, odd);
+    } catch(const runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && words.IsEmpty());
+    cout << "Done!" << endl << endl;
+}
+
+// Бросает исключение при копировании, пока fail установлен
+struct ThrowingCopy {
+    ThrowingCopy() = default;
+    ThrowingCopy(const ThrowingCopy&) {
+        if(fail) {
+            throw runtime_error("copy");
+        }
+    }
+
+    static inline bool fail = false;
+};
+
+void TestSoaVector() {
+    cout << "Test soa vector" << endl;
+    SoaSimpleVector<int, double, string> records;
+    for(int i = 0; i < 100; ++i) {
+        records.PushBack(i, i * 0.5, to_string(i));
+    }
+    assert(records.GetSize() == 100 && records.GetCapacity() >= 100);
+
+    // Столбцы непрерывны
+    [[maybe_unused]] auto ids = records.Column<0>();
+    assert(ids.GetSize() == 100 && accumulate(ids.begin(), ids.end(), 0) == 4950);
+    assert(records.Column<1>().Data() + 99 == &get<1>(records[99]));
+
+    auto [id, price, name] = records[10];
+    assert(id == 10 && price == 5.0 && name == "10"s);
+    price = 100.0;
+    assert(get<1>(records[10]) == 100.0);
+
+    auto it = records.Insert(records.begin() + 1, -1, -1.0, "inserted"s);
+    assert(get<2>(*it) == "inserted"s && records.GetSize() == 101);
+    assert(get<0>(records[0]) == 0 && get<0>(records[1]) == -1 && get<0>(records[2]) == 1);
+    it = records.Erase(records.begin());
+    assert(get<0>(*it) == -1 && records.GetSize() == 100);
+    records.PopBack();
+    assert(get<2>(records.At(98)) == "98"s);
+
+    SoaSimpleVector<int, double, string> copy = records;
+    assert(copy == records);
+    get<2>(copy[0]) = "changed"s;
+    assert(copy != records);
+
+    // Итераторы строк работают со стандартными алгоритмами
+    [[maybe_unused]] const auto found = find_if(records.cbegin(), records.cend(), [](const auto& row) {
+        return get<2>(row) == "50"s;
+    });
+    assert(found - records.cbegin() == 50);
+
+    records.Resize(200);
+    assert(get<0>(records[150]) == 0 && get<2>(records[150]).empty());
+    records.Clear();
+    assert(records.IsEmpty());
+
+    // Столбцы без копирования, строки переносятся при росте
+    SoaSimpleVector<unique_ptr<int>, int> owners(Reserve(1));
+    owners.PushBack(make_unique<int>(1), 1);
+    owners.PushBack(make_unique<int>(2), 2);
+    assert(*get<0>(owners[1]) == 2 && owners.GetCapacity() == 2);
+
+    // Политика роста задаётся так же, как у SimpleVector
+    BasicSoaSimpleVector<HalfGrowth, int, double> half(Reserve(4));
+    for(int i = 0; i < 5; ++i) {
+        half.PushBack(i, i * 2.0);
+    }
+    assert(half.GetCapacity() == 6 && get<1>(half[4]) == 8.0);
+
+    // Исключение при копировании столбца не портит столбцы, перемещаемые без исключений
+    SoaSimpleVector<string, ThrowingCopy> guarded;
+    guarded.PushBack("first"s, ThrowingCopy());
+    ThrowingCopy::fail = true;
+    try {
+        guarded.Reserve(guarded.GetCapacity() + 1);
+        assert(false);
+    } catch(const runtime_error&) {
+    }
+    ThrowingCopy::fail = false;
+    assert(guarded.GetSize() == 1 && get<0>(guarded[0]) == "first"s);
+    cout << "Done!" << endl << endl;
+}
+
+void TestSharedVector() {
+    cout << "Test shared vector" << endl;
+    SharedSimpleVector<string> original{"a"s, "b"s, "c"s};
+    // Копия делит буфер, чтение через const не отделяет его
+    const SharedSimpleVector<string> snapshot = original;
+    assert(snapshot.IsShared() && original.IsShared());
+    assert(snapshot.cbegin() == original.cbegin());
+    assert(snapshot[1] == "b"s && snapshot.At(2) == "c"s);
+    assert(snapshot == original);
+
+    // Первая запись копирует буфер, снимок не меняется
+    original[0] = "changed"s;
+    assert(!original.IsShared() && !snapshot.IsShared());
+    assert(snapshot.cbegin() != original.cbegin());
+    assert(snapshot[0] == "a"s && original[0] == "changed"s);
+
+    // Собственный буфер больше не копируется
+    [[maybe_unused]] const string* data = original.cbegin();
+    original[1] = "b2"s;
+    assert(original.cbegin() == data);
+
+    // Позиция из разделённого буфера переносится в отделённый
+    SharedSimpleVector<string> inserted = snapshot;
+    [[maybe_unused]] auto it = inserted.Insert(inserted.cbegin() + 1, "x"s);
+    assert(*it == "x"s && inserted.GetSize() == 4 && snapshot.GetSize() == 3);
+    SharedSimpleVector<string> erased = snapshot;
+    it = erased.Erase(erased.cbegin());
+    assert(*it == "b"s && erased.GetSize() == 2 && snapshot[0] == "a"s);
+
+    SharedSimpleVector<string> pushed = snapshot;
+    pushed.PushBack("d"s);
+    pushed.Resize(10);
+    assert(pushed.GetSize() == 10 && snapshot.GetSize() == 3);
+
+    // Очистка разделённого вектора не копирует буфер
+    SharedSimpleVector<string> cleared = snapshot;
+    cleared.Clear();
+    assert(cleared.IsEmpty() && snapshot.GetSize() == 3 && !snapshot.IsShared());
+
+    // Обычный вектор передаётся без копирования элементов
+    SimpleVector<int> source(1000, 7);
+    [[maybe_unused]] const int* source_data = source.cbegin();
+    SharedSimpleVector<int> adopted(std::move(source));
+    assert(adopted.cbegin() == source_data && adopted.Get().GetSize() == 1000);
+
+    // Ссылка, выданная до копирования, не может изменить копию
+    SharedSimpleVector<int> pinned{1, 2, 3};
+    int& first = pinned[0];
+    const SharedSimpleVector<int> pinned_copy = pinned;
+    first = 42;
+    assert(!pinned.IsShared() && pinned.IsUnshareable());
+    assert(pinned_copy[0] == 1 && pinned[0] == 42);
+    auto pinned_it = pinned.begin();
+    SharedSimpleVector<int> pinned_assigned;
+    pinned_assigned = pinned;
+    *pinned_it = 7;
+    assert(as_const(pinned_assigned)[0] == 42);
+    pinned = pinned_copy;
+    assert(!pinned.IsUnshareable() && pinned.IsShared());
+
+    // PushBack ссылку не отдаёт, копия продолжает делить буфер
+    SharedSimpleVector<int> appended;
+    appended.PushBack(1);
+    const SharedSimpleVector<int> appended_copy = appended;
+    assert(appended_copy.IsShared() && appended_copy.cbegin() == appended.cbegin());
+
+    // Заполненный через operator[] вектор после Freeze снова раздаёт снимки за O(1)
+    SharedSimpleVector<int> config(4);
+    for(size_t i = 0; i < config.GetSize(); ++i) {
+        config[i] = static_cast<int>(i * 10);
+    }
+    assert(config.IsUnshareable());
+    config.Freeze();
+    const SharedSimpleVector<int> config_snapshot = config;
+    assert(!config.IsUnshareable() && config_snapshot.IsShared());
+    assert(config_snapshot.cbegin() == config.cbegin() && config_snapshot[3] == 30);
+
+    SharedSimpleVector<int> empty;
+    assert(empty.IsEmpty() && empty.begin() == empty.end());
+    empty.PushBack(1);
+    assert(empty.GetSize() == 1 && empty < adopted);
+    cout << "Done!" << endl << endl;
+}
+
+void TestPersistentVector() {
+    cout << "Test persistent vector" << endl;
+    // Несколько уровней дерева: 32 * 32 * 32 < 50000
+    const size_t size = 50000;
+    PersistentSimpleVector<int> empty;
+    PersistentSimpleVector<int> built = empty;
+    for(size_t i = 0; i < 100; ++i) {
+        built = built.PushBack(static_cast<int>(i));
+    }
+    assert(empty.IsEmpty() && built.GetSize() == 100 && built[99] == 99);
+
+    PersistentSimpleVector<int>::Transient transient = built.ToTransient();
+    for(size_t i = 100; i < size; ++i) {
+        transient.PushBack(static_cast<int>(i));
+    }
+    const PersistentSimpleVector<int> base = transient.Persistent();
+    assert(base.GetSize() == size && built.GetSize() == 100);
+    for(size_t i = 0; i < size; ++i) {
+        assert(base[i] == static_cast<int>(i));
+    }
+
+    // Версии не влияют друг на друга
+    const auto changed = base.Set(12345, -1).Set(size - 1, -2).Set(0, -3);
+    assert(changed[12345] == -1 && changed[size - 1] == -2 && changed[0] == -3);
+    assert(base[12345] == 12345 && base[size - 1] == static_cast<int>(size - 1) && base[0] == 0);
+    assert(changed != base && base.Set(5, 5) == base);
+
+    // Построитель после Persistent() не меняет отданную версию
+    transient.Set(1, -10).PopBack();
+    assert(transient[1] == -10 && transient.GetSize() == size - 1);
+    assert(base[1] == 1 && base.GetSize() == size);
+
+    // PopBack до пустого вектора через все уровни дерева
+    PersistentSimpleVector<int> shrinking = base;
+    for(size_t i = size; i > 0; --i) {
+        assert(shrinking.GetSize() == i && shrinking[i - 1] == static_cast<int>(i - 1));
+        shrinking = shrinking.PopBack();
+    }
+    assert(shrinking.IsEmpty() && base.GetSize() == size);
+
+    // Пакетное преобразование в обе стороны и конкатенация
+    SimpleVector<int> plain = base.ToSimpleVector();
+    assert(plain.GetSize() == size && plain[777] == 777);
+    const PersistentSimpleVector<int> from_plain(plain);
+    assert(from_plain == base);
+    const auto joined = built.Concat(base);
+    assert(joined.GetSize() == size + 100 && joined[99] == 99 && joined[100] == 0 && joined[size + 99] == static_cast<int>(size - 1));
+    assert(accumulate(joined.begin(), joined.end(), int64_t{0}) == 4950 + int64_t{size} * (size - 1) / 2);
+
+    const PersistentSimpleVector<string> names{"a"s, "b"s};
+    assert(names.PushBack("c"s).At(2) == "c"s && names.GetSize() == 2);
+    try {
+        names.At(2);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+    cout << "Done!" << endl << endl;
+}
+
+#if SIMPLE_VECTOR_HAS_CONSTEXPR20
+// Таблица квадратов, построенная при компиляции
+constexpr StaticSimpleVector<int, 16> MakeSquares() {
+    StaticSimpleVector<int, 16> squares;
+    for(int i = 0; i < 10; ++i) {
+        squares.PushBack(i * i);
+    }
+    squares.Erase(squares.begin());
+    squares.Insert(squares.begin(), -1);
+    return squares;
+}
+
+constexpr size_t CountLongWords() {
+    StaticSimpleVector<string, 4> words{"parse"s, "a"s, "token"s};
+    words.Insert(words.begin() + 1, "buffer"s);
+    size_t count = 0;
+    for(const string& word : words) {
+        count += word.size() > 1 ? 1 : 0;
+    }
+    return count;
+}
+
+// RejectOverflow и при компиляции сообщает о переполнении результатом, а не ошибкой
+constexpr bool PushIntoFull() {
+    StaticSimpleVector<int, 1, RejectOverflow> single{1};
+    return single.PushBack(2);
+}
+
+constexpr auto kSquares = MakeSquares();
+static_assert(kSquares.GetSize() == 10 && kSquares[0] == -1 && kSquares[9] == 81);
+static_assert(CountLongWords() == 3);
+static_assert(!PushIntoFull());
+#endif
+
+void TestStaticVector() {
+    cout << "Test static vector" << endl;
+    // Элементы лежат внутри объекта
+    StaticSimpleVector<int, 8> numbers{1, 2, 3};
+    static_assert(sizeof(numbers) == 8 * sizeof(int) + sizeof(size_t));
+    assert(reinterpret_cast<const char*>(numbers.begin()) >= reinterpret_cast<const char*>(&numbers));
+    assert(reinterpret_cast<const char*>(numbers.end()) <= reinterpret_cast<const char*>(&numbers + 1));
+
+    assert(*numbers.Insert(numbers.begin() + 1, 10) == 10);
+    assert((numbers == StaticSimpleVector<int, 8>{1, 10, 2, 3}));
+    assert(*numbers.Erase(numbers.begin()) == 10);
+    assert(numbers.Resize(5) && numbers[4] == 0 && numbers.At(0) == 10);
+    assert((numbers < StaticSimpleVector<int, 8>{10, 2, 4}) && (numbers >= StaticSimpleVector<int, 8>{10}));
+    numbers.PopBack();
+    assert(numbers.GetSize() == 4);
+
+    // Политики переполнения
+    StaticSimpleVector<int, 2, RejectOverflow> rejecting{1, 2};
+    assert(rejecting.IsFull() && !rejecting.PushBack(3) && rejecting.EmplaceBack(3) == nullptr);
+    assert(rejecting.Insert(rejecting.begin(), 0) == rejecting.end() && rejecting[0] == 1);
+    assert(!rejecting.Resize(3) && rejecting.GetSize() == 2);
+    [[maybe_unused]] const int source[] = {7, 8, 9};
+    rejecting.Clear();
+    assert(!rejecting.Append(begin(source), end(source)) && rejecting.IsEmpty());
+
+    StaticSimpleVector<string, 2, ThrowOverflow> throwing{"a"s, "b"s};
+    try {
+        throwing.PushBack("c"s);
+        assert(false);
+    } catch(const length_error&) {
+    }
+    assert(throwing.GetSize() == 2 && throwing[1] == "b"s);
+    try {
+        throwing.At(2);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+
+    // Нетривиальные элементы создаются и разрушаются вектором
+    StaticSimpleVector<string, 4> words{"b"s, "c"s};
+    words.Insert(words.begin(), words[1]);
+    StaticSimpleVector<string, 4> copy = words;
+    assert(copy[0] == "c"s && copy.GetSize() == 3);
+    StaticSimpleVector<string, 4> moved = std::move(copy);
+    assert(moved == words);
+    StaticSimpleVector<string, 4> other{"x"s};
+    other.swap(moved);
+    assert(other == words && moved.GetSize() == 1 && moved[0] == "x"s);
+    words.EraseRange(words.begin(), words.begin() + 2);
+    assert(words.GetSize() == 1 && words[0] == "c"s);
+    cout << "Done!" << endl << endl;
+}
+
+void TestFlatContainers() {
+    cout << "Test flat containers" << endl;
+    FlatSet<int> set{5, 1, 3, 1};
+    assert(set.GetSize() == 3 && *set.begin() == 1 && set.Contains(3) && !set.Contains(2));
+    assert(set.Insert(2).second && !set.Insert(2).second && set.GetSize() == 4);
+    assert(*set.LowerBound(4) == 5 && *set.UpperBound(3) == 5 && set.LowerBound(6) == set.end());
+
+    // Пакетная вставка: сортировка добавленных и слияние за один проход
+    SimpleVector<int> batch;
+    for(int i = 1000; i > 0; --i) {
+        batch.PushBack(i * 2);
+    }
+    set.InsertMany(batch.begin(), batch.end());
+    assert(set.GetSize() == 1000 + 3 && is_sorted(set.begin(), set.end()));
+    assert(adjacent_find(set.begin(), set.end()) == set.end());
+    for(int i = 0; i <= 2002; ++i) {
+        assert(set.Contains(i) == (i % 2 == 0 ? i > 0 && i <= 2000 : i <= 5));
+    }
+    assert(set.Erase(3) == 1 && set.Erase(3) == 0 && set.Find(3) == set.end());
+
+    // Хранилище передаётся без копирования
+    [[maybe_unused]] const int* data = set.begin();
+    SimpleVector<int> keys = set.ExtractSequence();
+    assert(set.IsEmpty() && keys.cbegin() == data);
+    set.AdoptSequence(std::move(keys));
+    assert(set.begin() == data && set.GetSize() == 1002);
+    SimpleVector<string> unsorted{"pear"s, "apple"s, "fig"s, "apple"s};
+    const FlatSet<string> fruits(std::move(unsorted));
+    assert((fruits.GetSequence() == SimpleVector<string>{"apple"s, "fig"s, "pear"s}));
+
+    FlatMap<string, int> map{{"b"s, 2}, {"a"s, 1}, {"b"s, 20}};
+    assert(map.GetSize() == 2 && map.At("b"s) == 2 && map.Find("c"s) == map.end());
+    map["c"s] = 3;
+    ++map["a"s];
+    assert(map.At("a"s) == 2 && map.At("c"s) == 3);
+    assert(!map.Insert("a"s, 100).second && (*map.InsertOrAssign("a"s, 100)).second == 100);
+    try {
+        map.At("z"s);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+
+    // Ключи и значения в отдельных массивах, обход даёт пары ссылок
+    SimpleVector<pair<string, int>> entries;
+    for(int i = 0; i < 100; ++i) {
+        entries.PushBack({to_string(i), i});
+    }
+    map.InsertMany(entries.begin(), entries.end());
+    assert(map.GetSize() == 103 && is_sorted(map.Keys().begin(), map.Keys().end()));
+    for(auto [key, value] : map) {
+        assert(key.size() > 1 || !isdigit(key[0]) || stoi(key) == value);
+        value += 1000;
+    }
+    assert(map.At("42"s) == 1042 && map.Values()[map.Find("c"s).GetIndex()] == 1003);
+    assert(map.Erase("42"s) == 1 && !map.Contains("42"s));
+
+    auto [map_keys, map_values] = map.ExtractSequence();
+    assert(map.IsEmpty() && map_keys.GetSize() == 102 && map_values.GetSize() == 102);
+    FlatMap<string, int> adopted;
+    adopted.AdoptSequence(std::move(map_keys), std::move(map_values));
+    assert(adopted.At("a"s) == 1100 && adopted != map);
+    cout << "Done!" << endl << endl;
+}
+
+void TestAlignedAllocator() {
+    cout << "Test aligned allocator" << endl;
+    [[maybe_unused]] auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    };
+    // Небольшие буферы выровнены по кеш-линии при каждом перевыделении
+    AlignedSimpleVector<float> small;
+    for(int i = 0; i < 1000; ++i) {
+        small.PushBack(static_cast<float>(i));
+        assert(is_aligned(small.cbegin(), 64));
+    }
+    assert(small.Sum() == 499500.0f);
+
+    // Большой буфер отображается через mmap и выровнен по большой странице
+    AlignedSimpleVector<float> large(1 << 20, 1.0f);
+    assert(is_aligned(large.cbegin(), AlignedAllocator<float>::kHugePageSize));
+    large.PushBack(2.0f);
+    assert(is_aligned(large.cbegin(), AlignedAllocator<float>::kHugePageSize));
+    assert(large[0] == 1.0f && large[1 << 20] == 2.0f && large.GetSize() == (1 << 20) + 1);
+
+    // Низкий порог: mmap и для маленьких буферов, нетривиальные элементы
+    SimpleVector<string, AlignedAllocator<string, 128, 4096>> mapped;
+    for(int i = 0; i < 1000; ++i) {
+        mapped.PushBack(to_string(i));
+    }
+    assert(is_aligned(mapped.cbegin(), 128) && mapped[999] == "999"s);
+    auto copy = mapped;
+    assert(copy == mapped);
+    copy.ShrinkToFit();
+    assert(copy.GetCapacity() == 1000 && copy[500] == "500"s);
+
+    assert((AlignedAllocator<int>() == AlignedAllocator<double>()));
+    cout << "Done!" << endl << endl;
+}
+
+void TestSimpleDeque() {
+    cout << "Test simple deque" << endl;
+    // Очередь работ: добавление в конец, извлечение из начала без сдвига буфера
+    SimpleDeque<int> queue;
+    for(int i = 0; i < 5; ++i) {
+        queue.PushBack(i);
+    }
+    [[maybe_unused]] const size_t capacity = queue.GetCapacity();
+    assert(capacity == 8);
+    for(int i = 5; i < 1000; ++i) {
+        assert(queue.Front() == i - 5);
+        queue.PopFront();
+        queue.PushBack(i);
+    }
+    assert(queue.GetCapacity() == capacity && queue.GetSize() == 5 && queue.Back() == 999);
+
+    SimpleDeque<int> front;
+    for(int i = 0; i < 100; ++i) {
+        front.PushFront(i);
+    }
+    assert(front.Front() == 99 && front.Back() == 0 && front.At(10) == 89);
+
+    // Вставка и удаление сдвигают более короткую сторону
+    SimpleDeque<string> words{"b"s, "c"s, "d"s, "e"s};
+    words.PushFront("a"s);
+    auto it = words.Insert(words.begin() + 1, "x"s);
+    assert(*it == "x"s && words[0] == "a"s && words[2] == "b"s);
+    it = words.Insert(words.end() - 1, "y"s);
+    assert(*it == "y"s && words.Back() == "e"s);
+    it = words.Erase(words.begin() + 1);
+    assert(*it == "b"s);
+    it = words.Erase(words.end() - 2);
+    assert(*it == "e"s);
+    assert((words == SimpleDeque<string>{"a"s, "b"s, "c"s, "d"s, "e"s}));
+    words.Insert(words.begin(), words[4]);
+    assert(words.Front() == "e"s && words.GetSize() == 6);
+
+    // Linearize переставляет элементы на месте, не выделяя памяти
+    SimpleDeque<int> ring;
+    for(int i = 0; i < 8; ++i) {
+        ring.PushBack(i);
+    }
+    for(int i = 8; i < 13; ++i) {
+        ring.PopFront();
+        ring.PushBack(i);
+    }
+    [[maybe_unused]] const int* data = ring.Linearize();
+    assert(ring.GetCapacity() == 8 && data == &ring[0]);
+    for(int i = 0; i < 8; ++i) {
+        assert(data[i] == i + 5);
+    }
+    SimpleDeque<string> text;
+    for(int i = 0; i < 8; ++i) {
+        text.PushFront(to_string(i));
+    }
+    text.PopBack();
+    text.PushFront("front"s);
+    [[maybe_unused]] string* strings = text.Linearize();
+    assert(strings[0] == "front"s && strings[1] == "7"s && strings[7] == "1"s);
+    text.PopBack();
+    text.PopBack();
+    text.PushFront("x"s);
+    strings = text.Linearize();
+    assert(text.GetSize() == 7 && strings[0] == "x"s && strings[1] == "front"s && strings[6] == "3"s);
+
+    // Некопируемые элементы переносятся при росте
+    SimpleDeque<unique_ptr<int>> owners;
+    for(int i = 0; i < 20; ++i) {
+        owners.PushFront(make_unique<int>(i));
+    }
+    assert(*owners.Front() == 19 && *owners.Back() == 0);
+    SimpleDeque<unique_ptr<int>> moved = std::move(owners);
+    assert(owners.IsEmpty() && moved.GetSize() == 20);
+    moved.Resize(2);
+    assert(*moved[1] == 18 && !(front < front) && queue != SimpleDeque<int>(5));
+
+    // Вместимость больше старшей степени двойки size_t не округляется, а отвергается
+    SimpleDeque<int> huge{1, 2};
+    try {
+        huge.Reserve(SIZE_MAX / 2 + 2);
+        assert(false);
+    } catch(const length_error&) {
+    }
+    assert(huge.GetSize() == 2 && huge.GetCapacity() == 2);
+    cout << "Done!" << endl << endl;
+}
+
+void TestEraseIf() {
+    cout << "Test erase if" << endl;
+    // Арифметические элементы: сжатие без ветвлений, порядок сохраняется
+    SimpleVector<int> numbers(100000);
+    iota(numbers.begin(), numbers.end(), 0);
+    assert(numbers.EraseIf([](int x) {
+        return x % 3 == 0;
+    }) == 33334);
+    assert(numbers.GetSize() == 66666 && numbers[0] == 1 && numbers[1] == 2 && numbers[2] == 4);
+    assert(is_sorted(numbers.begin(), numbers.end()) && numbers.Count(99999) == 0);
+    assert(numbers.EraseIf([](int) {
+        return false;
+    }) == 0 && numbers.GetSize() == 66666);
+
+    // Нетривиальные элементы разрушаются ровно один раз
+    SimpleVector<string> words{"keep"s, "drop"s, "keep2"s, "drop"s, "drop"s, "keep3"s};
+    assert(words.EraseIf([](const string& word) {
+        return word == "drop"s;
+    }) == 3);
+    assert((words == SimpleVector<string>{"keep"s, "keep2"s, "keep3"s}));
+
+    // Удаление с заполнением дыры последним элементом
+    [[maybe_unused]] auto it = words.SwapRemove(words.begin());
+    assert(*it == "keep3"s && words.GetSize() == 2);
+    it = words.SwapRemove(words.end() - 1);
+    assert(it == words.end() && words.GetSize() == 1);
+
+    SimpleVector<unique_ptr<int>> owners;
+    for(int i = 0; i < 1000; ++i) {
+        owners.PushBack(make_unique<int>(i));
+    }
+    assert(owners.UnorderedEraseIf([](const unique_ptr<int>& ptr) {
+        return *ptr % 2 == 1 || *ptr >= 900;
+    }) == 550);
+    assert(owners.GetSize() == 450);
+    SimpleVector<int> left;
+    for(const auto& ptr : owners) {
+        left.PushBack(*ptr);
+    }
+    sort(left.begin(), left.end());
+    for(int i = 0; i < 450; ++i) {
+        assert(left[i] == 2 * i);
+    }
+    assert(owners.UnorderedEraseIf([](const unique_ptr<int>&) {
+        return true;
+    }) == 450 && owners.IsEmpty());
+    cout << "Done!" << endl << endl;
+}
+
+void TestVectorView() {
+    cout << "Test vector view" << endl;
+    SimpleVector<int> numbers(10);
+    iota(numbers.begin(), numbers.end(), 0);
+
+    // Представление не копирует данные
+    SimpleVectorView view(numbers);
+    assert(view.Data() == numbers.begin() && view.GetSize() == 10);
+    view[0] = 100;
+    assert(numbers[0] == 100);
+    numbers[0] = 0;
+
+    const SimpleVector<int>& const_numbers = numbers;
+    [[maybe_unused]] SimpleVectorView<const int> read_only = const_numbers;
+    [[maybe_unused]] SimpleVectorView<const int> from_mutable = view;
+    assert(read_only == from_mutable);
+
+    auto middle = view.Slice(3, 4);
+    assert(middle.Data() == numbers.begin() + 3 && middle.GetSize() == 4 && middle.Front() == 3 && middle.Back() == 6);
+    assert(view.Slice(8).GetSize() == 2 && view.Slice(10).IsEmpty());
+    assert(view.First(3).Back() == 2 && view.Last(20).GetSize() == 10);
+    try {
+        view.Slice(11);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+    try {
+        middle.At(4);
+        assert(false);
+    } catch(const out_of_range&) {
+    }
+
+    auto chunks = view.Chunks(4);
+    assert(chunks.GetSize() == 3 && chunks[2].GetSize() == 2 && chunks[2].Front() == 8);
+    int chunk_sum = 0;
+    for(auto chunk : chunks) {
+        chunk_sum += chunk.Front();
+    }
+    assert(chunk_sum == 0 + 4 + 8);
+
+    auto windows = view.Windows(3);
+    assert(windows.GetSize() == 8 && view.Windows(11).IsEmpty());
+    for(size_t i = 0; i < windows.GetSize(); ++i) {
+        assert(windows[i].GetSize() == 3 && windows[i].Front() == static_cast<int>(i));
+    }
+
+    // Конвейер ленивый: функции вызываются только при Collect и не дальше Take
+    int calls = 0;
+    auto pipeline = view.Map([&calls](int x) {
+        ++calls;
+        return x * x;
+    }).Filter([](int x) {
+        return x % 2 == 0;
+    }).Take(3);
+    assert(calls == 0 && !pipeline.IsSizeExact());
+    SimpleVector<int> squares = pipeline.Collect();
+    assert((squares == SimpleVector<int>{0, 4, 16}));
+    assert(calls == 5);
+    assert(squares.GetCapacity() == 3);
+
+    auto exact = view.Slice(2, 5).Map([](int x) {
+        return to_string(x);
+    });
+    assert(exact.IsSizeExact() && exact.SizeBound() == 5);
+    SimpleVector<string> strings = exact.Collect();
+    assert(strings.GetCapacity() == 5 && strings[0] == "2"s && strings[4] == "6"s);
+    exact.CollectInto(strings);
+    assert(strings.GetSize() == 10 && strings[5] == "2"s);
+    assert(view.Take(0).Collect().IsEmpty());
+
+    // Изменение через представление
+    view.Filter([](int x) {
+        return x >= 5;
+    }).ForEach([](int& x) {
+        x = -x;
+    });
+    assert(numbers[4] == 4 && numbers[5] == -5 && numbers[9] == -9);
+
+#if SIMPLE_VECTOR_HAS_SPAN
+    std::span<int> span = view;
+    assert(span.data() == numbers.begin() && span.size() == 10);
+    [[maybe_unused]] SimpleVectorView<const int> back = span.subspan(2, 3);
+    assert(back.GetSize() == 3 && back[0] == 2);
+#endif
+    cout << "Done!" << endl << endl;
+}
+
 int main() {
     TestTemporaryObjConstructor();
     TestTemporaryObjOperator();
@@ -158,5 +1516,28 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestUninitializedCapacity();
+    TestEmplace();
+    TestMoveIsCheap();
+    TestTriviallyRelocatable();
+    TestPmrAllocator();
+    TestSmallVector();
+    TestGrowthPolicy();
+    TestRangeOperations();
+    TestStats();
+    TestSimdKernels();
+    TestParallelAlgorithms();
+    TestConcurrentVector();
+    TestMappedVector();
+    TestSerialization();
+    TestSoaVector();
+    TestSharedVector();
+    TestPersistentVector();
+    TestStaticVector();
+    TestFlatContainers();
+    TestAlignedAllocator();
+    TestSimpleDeque();
+    TestEraseIf();
+    TestVectorView();
     return 0;
 }
\ No newline at end of file
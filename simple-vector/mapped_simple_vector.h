@@ -0,0 +1,349 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "simple_vector_traits.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Вектор тривиально копируемых элементов, хранящийся в отображённом в память файле.
+// Файл начинается с заголовка (сигнатура, версия формата, размер элемента, размер
+// и вместимость), за которым лежат элементы. Открытие существующего файла ничего
+// не читает: страницы подгружаются ядром при первом обращении, поэтому данные
+// могут быть больше оперативной памяти. Рост вместимости - ftruncate и mremap.
+// Изменения попадают в файл через общий кеш страниц; Sync() дожидается их записи на диск.
+// Ошибки системных вызовов выбрасываются как std::system_error.
+// Перемещённый вектор закрыт: он пуст, а изменяющие операции выбрасывают std::logic_error.
+template <typename Type, typename Growth = DoublingGrowth>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable types can be stored in a file");
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+        uint64_t capacity;
+    };
+
+    // Данные начинаются с границы кеш-линии, это же ограничивает выравнивание Type
+    static constexpr size_t kDataOffset = 64;
+    static_assert(sizeof(Header) <= kDataOffset && alignof(Type) <= kDataOffset);
+    static constexpr char kMagic[8] = {'S', 'V', 'M', 'A', 'P', 'P', 'E', 'D'};
+    static constexpr uint32_t kVersion = 1;
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    MappedSimpleVector(const MappedSimpleVector&) = delete;
+    MappedSimpleVector& operator=(const MappedSimpleVector&) = delete;
+
+    MappedSimpleVector(MappedSimpleVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          base_(std::exchange(other.base_, nullptr)),
+          mapped_bytes_(std::exchange(other.mapped_bytes_, 0)),
+          read_only_(other.read_only_) {
+    }
+
+    MappedSimpleVector& operator=(MappedSimpleVector&& rhs) noexcept {
+        if(this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            mapped_bytes_ = std::exchange(rhs.mapped_bytes_, 0);
+            read_only_ = rhs.read_only_;
+        }
+        return *this;
+    }
+
+    // Снимает отображение и закрывает файл. Записанные данные остаются в кеше страниц
+    // и попадут на диск позже; для гарантированной записи нужен Sync()
+    ~MappedSimpleVector() {
+        Close();
+    }
+
+    // Создаёт пустой вектор в файле path (существующий файл перезаписывается)
+    static MappedSimpleVector Create(const std::string& path, size_t capacity = 0) {
+        MappedSimpleVector vector(OpenFile(path, O_RDWR | O_CREAT | O_TRUNC), false);
+        const size_t bytes = BytesFor(capacity);
+        vector.Truncate(bytes);
+        vector.Map(bytes);
+        Header& header = vector.GetHeader();
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.element_size = sizeof(Type);
+        header.size = 0;
+        header.capacity = capacity;
+        return vector;
+    }
+
+    // Открывает существующий файл для чтения и записи
+    static MappedSimpleVector Open(const std::string& path) {
+        return OpenExisting(path, false);
+    }
+
+    // Открывает существующий файл только для чтения, не копируя данные
+    static MappedSimpleVector OpenReadOnly(const std::string& path) {
+        return OpenExisting(path, true);
+    }
+
+    size_t GetSize() const noexcept {
+        return IsOpen() ? GetHeader().size : 0;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return IsOpen() ? GetHeader().capacity : 0;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return read_only_;
+    }
+
+    // Возвращает false у перемещённого вектора
+    bool IsOpen() const noexcept {
+        return base_ != nullptr;
+    }
+
+    // Возвращает ссылку на элемент с индексом index. Страницы файла, открытого
+    // только для чтения, защищены от записи: запись через ссылку завершит процесс по SIGSEGV
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if(index >= GetSize()) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return Data()[index];
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return begin() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    // Добавляет элемент в конец. args копируются до роста: они могут ссылаться на элементы вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        RequireWritable();
+        Type item = vector_detail::Make<Type>(std::forward<Args>(args)...);
+        const size_t size = GetSize();
+        if(size == GetCapacity()) {
+            Remap(Growth::NextCapacity(GetCapacity(), size + 1, sizeof(Type)));
+        }
+        Type* slot = new (Data() + size) Type(item);
+        ++GetHeader().size;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        assert(GetSize() != 0 && !read_only_);
+        --GetHeader().size;
+    }
+
+    // Изменяет размер, новые элементы инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        RequireWritable();
+        const size_t size = GetSize();
+        if(new_size > GetCapacity()) {
+            Remap(Growth::NextCapacity(GetCapacity(), new_size, sizeof(Type)));
+        }
+        if(new_size > size) {
+            std::uninitialized_value_construct_n(Data() + size, new_size - size);
+        }
+        GetHeader().size = new_size;
+    }
+
+    void Reserve(size_t new_capacity) {
+        RequireWritable();
+        if(new_capacity > GetCapacity()) {
+            Remap(new_capacity);
+        }
+    }
+
+    void Clear() {
+        RequireWritable();
+        GetHeader().size = 0;
+    }
+
+    // Дожидается записи изменённых страниц на диск
+    void Sync() {
+        if(IsOpen() && !read_only_ && msync(base_, mapped_bytes_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+private:
+    MappedSimpleVector(int fd, bool read_only) noexcept
+        : fd_(fd), read_only_(read_only) {
+    }
+
+    static size_t BytesFor(size_t capacity) {
+        if(capacity > (SIZE_MAX - kDataOffset) / sizeof(Type)) {
+            throw std::length_error("MappedSimpleVector capacity is too large");
+        }
+        return kDataOffset + capacity * sizeof(Type);
+    }
+
+    static int OpenFile(const std::string& path, int flags) {
+        const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if(fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        return fd;
+    }
+
+    static MappedSimpleVector OpenExisting(const std::string& path, bool read_only) {
+        MappedSimpleVector vector(OpenFile(path, read_only ? O_RDONLY : O_RDWR), read_only);
+        struct stat info;
+        if(fstat(vector.fd_, &info) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fstat " + path);
+        }
+        const size_t bytes = static_cast<size_t>(info.st_size);
+        if(bytes < kDataOffset) {
+            throw std::runtime_error(path + " is not a MappedSimpleVector file");
+        }
+        vector.Map(bytes);
+        const Header& header = vector.GetHeader();
+        if(std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+            throw std::runtime_error(path + " is not a MappedSimpleVector file");
+        }
+        if(header.element_size != sizeof(Type)) {
+            throw std::runtime_error(path + " stores elements of a different size");
+        }
+        if(header.size > header.capacity || header.capacity > (bytes - kDataOffset) / sizeof(Type)) {
+            throw std::runtime_error(path + " is truncated");
+        }
+        return vector;
+    }
+
+    void Map(size_t bytes) {
+        const int protection = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* base = mmap(nullptr, bytes, protection, MAP_SHARED, fd_, 0);
+        if(base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        base_ = static_cast<char*>(base);
+        mapped_bytes_ = bytes;
+    }
+
+    void Truncate(size_t bytes) {
+        if(ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+        }
+    }
+
+    // Увеличивает файл и отображение до new_capacity элементов.
+    // Адрес отображения может измениться, элементы при этом не копируются
+    void Remap(size_t new_capacity) {
+        const size_t bytes = BytesFor(new_capacity);
+        Truncate(bytes);
+#ifdef __linux__
+        void* base = mremap(base_, mapped_bytes_, bytes, MREMAP_MAYMOVE);
+        if(base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mremap");
+        }
+        base_ = static_cast<char*>(base);
+        mapped_bytes_ = bytes;
+#else
+        void* old_base = base_;
+        const size_t old_bytes = mapped_bytes_;
+        Map(bytes);
+        munmap(old_base, old_bytes);
+#endif
+        GetHeader().capacity = new_capacity;
+    }
+
+    void RequireWritable() const {
+        if(!IsOpen()) {
+            throw std::logic_error("MappedSimpleVector is closed");
+        }
+        if(read_only_) {
+            throw std::logic_error("MappedSimpleVector is opened read-only");
+        }
+    }
+
+    void Close() noexcept {
+        if(base_ != nullptr) {
+            munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+        }
+        if(fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // Заголовок и данные есть только у открытого вектора
+    Header& GetHeader() noexcept {
+        assert(IsOpen());
+        return *reinterpret_cast<Header*>(base_);
+    }
+
+    const Header& GetHeader() const noexcept {
+        assert(IsOpen());
+        return *reinterpret_cast<const Header*>(base_);
+    }
+
+    Type* Data() noexcept {
+        return IsOpen() ? reinterpret_cast<Type*>(base_ + kDataOffset) : nullptr;
+    }
+
+    const Type* Data() const noexcept {
+        return IsOpen() ? reinterpret_cast<const Type*>(base_ + kDataOffset) : nullptr;
+    }
+
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    bool read_only_ = false;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "simple_vector.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <optional>
+#include <vector>
+
+// Параллельные алгоритмы над SimpleVector. Работа делится на куски ChunkPlan,
+// границы которых лежат на границах кеш-линий, и выполняется на пуле политики policy.
+// С политикой Sequential() алгоритмы выполняются в вызывающем потоке.
+
+// Записывает в dest[i] значение op(source[i]). Размер dest становится равен размеру source,
+// недостающие элементы dest создаются значением по умолчанию.
+// source и dest могут быть одним вектором
+template <typename Type, typename Alloc, typename Growth, typename Result, typename ResultAlloc,
+          typename ResultGrowth, typename UnaryOp>
+void ParallelTransform(const SimpleVector<Type, Alloc, Growth>& source, SimpleVector<Result, ResultAlloc, ResultGrowth>& dest,
+                       UnaryOp op, ExecutionPolicy policy = Parallel()) {
+    dest.Resize(policy, source.GetSize());
+    const Type* input = source.begin();
+    Result* output = dest.begin();
+    ParallelForChunks(output, dest.GetSize(), policy, [&](size_t first, size_t last) {
+        for(size_t i = first; i < last; ++i) {
+            output[i] = op(input[i]);
+        }
+    });
+}
+
+// Сворачивает элементы операцией op, начиная с init. Куски сворачиваются независимо
+// и затем объединяются по порядку, поэтому op должна быть ассоциативной
+template <typename Type, typename Alloc, typename Growth, typename Value, typename BinaryOp = std::plus<>>
+Value ParallelReduce(const SimpleVector<Type, Alloc, Growth>& vector, Value init, BinaryOp op = BinaryOp(),
+                     ExecutionPolicy policy = Parallel()) {
+    const Type* data = vector.begin();
+    const ChunkPlan<Type> plan(data, vector.GetSize(), policy);
+    // Частичные результаты разных потоков не делят кеш-линию
+    struct alignas(ChunkPlan<Type>::kCacheLine) Partial {
+        std::optional<Value> value;
+    };
+    std::vector<Partial> partials(plan.GetCount());
+    auto reduce_chunk = [&](size_t chunk) {
+        const size_t first = plan.Begin(chunk);
+        const size_t last = plan.End(chunk);
+        if(first == last) {
+            return;
+        }
+        Value value = data[first];
+        for(size_t i = first + 1; i < last; ++i) {
+            value = op(std::move(value), data[i]);
+        }
+        partials[chunk].value = std::move(value);
+    };
+    if(plan.GetCount() == 1) {
+        reduce_chunk(0);
+    } else {
+        policy.ParallelFor(plan.GetCount(), reduce_chunk);
+    }
+    for(Partial& partial : partials) {
+        if(partial.value) {
+            init = op(std::move(init), std::move(*partial.value));
+        }
+    }
+    return init;
+}
+
+// Сортирует вектор: куски сортируются параллельно, затем попарно сливаются,
+// на каждом шаге слияния пары обрабатываются параллельно
+template <typename Type, typename Alloc, typename Growth, typename Compare = std::less<>>
+void ParallelSort(SimpleVector<Type, Alloc, Growth>& vector, Compare comp = Compare(), ExecutionPolicy policy = Parallel()) {
+    Type* data = vector.begin();
+    const ChunkPlan<Type> plan(data, vector.GetSize(), policy);
+    const size_t chunks = plan.GetCount();
+    if(chunks == 1) {
+        std::sort(data, data + vector.GetSize(), comp);
+        return;
+    }
+    policy.ParallelFor(chunks, [&](size_t chunk) {
+        std::sort(data + plan.Begin(chunk), data + plan.End(chunk), comp);
+    });
+    // Шаг width сливает отсортированные группы по width кусков в группы по 2 * width
+    for(size_t width = 1; width < chunks; width *= 2) {
+        const size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        policy.ParallelFor(pairs, [&](size_t pair) {
+            const size_t left = pair * 2 * width;
+            const size_t right = left + width;
+            if(right >= chunks) {
+                return;
+            }
+            const size_t last = std::min(right + width, chunks) - 1;
+            std::inplace_merge(data + plan.Begin(left), data + plan.Begin(right), data + plan.End(last), comp);
+        });
+    }
+}
@@ -0,0 +1,515 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Неизменяемый вектор со структурным разделением: префиксное дерево с ветвлением 32
+// по битам индекса и отдельным хвостом из последних (до 32) элементов.
+// Set, PushBack и PopBack не меняют вектор, а возвращают новую версию, копируя
+// только путь от корня до листа (O(log32 n), на практике не больше 6-7 узлов),
+// остальные узлы общие для всех версий. Добавление в конец обычно меняет только хвост.
+// Для пакетных изменений есть Transient: он правит на месте узлы, созданные им самим,
+// и копирует только общие с другими версиями.
+// Узлы освобождаются по счётчику ссылок, версии можно читать из разных потоков
+template <typename Type>
+class PersistentSimpleVector {
+    static constexpr size_t kBits = 5;
+    static constexpr size_t kWidth = size_t(1) << kBits;
+    static constexpr size_t kMask = kWidth - 1;
+
+    struct Node {
+        // Transient, которому разрешено менять узел на месте; 0 - узел неизменяем
+        uint64_t owner;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    struct Branch : Node {
+        explicit Branch(uint64_t owner) noexcept
+            : Node{owner} {
+        }
+
+        std::array<NodePtr, kWidth> children;
+    };
+
+    struct Leaf : Node {
+        explicit Leaf(uint64_t owner)
+            : Node{owner}, values(Reserve(kWidth)) {
+        }
+
+        // Копия сразу получает место под все 32 элемента
+        Leaf(const Leaf& other)
+            : Node{other.owner}, values(Reserve(kWidth)) {
+            values.Append(other.values.begin(), other.values.end());
+        }
+
+        SimpleVector<Type> values;
+    };
+
+    struct State {
+        State() noexcept = default;
+        State(const State& other) noexcept = default;
+        State& operator=(const State& rhs) noexcept = default;
+
+        State(State&& other) noexcept
+            : size(std::exchange(other.size, 0)),
+              shift(std::exchange(other.shift, kBits)),
+              root(std::move(other.root)),
+              tail(std::move(other.tail)) {
+        }
+
+        State& operator=(State&& rhs) noexcept {
+            if(this != &rhs) {
+                size = std::exchange(rhs.size, 0);
+                shift = std::exchange(rhs.shift, kBits);
+                root = std::move(rhs.root);
+                tail = std::move(rhs.tail);
+            }
+            return *this;
+        }
+
+        size_t size = 0;
+        // Сдвиг индекса для выбора потомка корня; листья находятся на уровне 0
+        size_t shift = kBits;
+        std::shared_ptr<Branch> root;
+        std::shared_ptr<Leaf> tail;
+    };
+
+public:
+    class Transient;
+
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        ConstIterator() = default;
+
+        reference operator*() const noexcept {
+            return chunk_[index_ & kMask];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        // Лист ищется заново только при переходе через границу 32 элементов
+        ConstIterator& operator++() noexcept {
+            ++index_;
+            if((index_ & kMask) == 0 && index_ < state_->size) {
+                chunk_ = ChunkFor(*state_, index_);
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            ConstIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const ConstIterator& rhs) const noexcept {
+            return index_ == rhs.index_;
+        }
+
+        bool operator!=(const ConstIterator& rhs) const noexcept {
+            return index_ != rhs.index_;
+        }
+
+    private:
+        friend class PersistentSimpleVector;
+
+        ConstIterator(const State* state, size_t index) noexcept
+            : state_(state), index_(index), chunk_(index < state->size ? ChunkFor(*state, index) : nullptr) {
+        }
+
+        const State* state_ = nullptr;
+        size_t index_ = 0;
+        const Type* chunk_ = nullptr;
+    };
+
+    PersistentSimpleVector() noexcept = default;
+
+    PersistentSimpleVector(std::initializer_list<Type> init) {
+        AppendRange(state_, NextOwner(), init.begin(), init.end());
+    }
+
+    // Создаёт вектор из обычного, копируя элементы блоками по 32
+    template <typename Alloc, typename Growth>
+    explicit PersistentSimpleVector(const SimpleVector<Type, Alloc, Growth>& vector) {
+        AppendRange(state_, NextOwner(), vector.begin(), vector.end());
+    }
+
+    size_t GetSize() const noexcept {
+        return state_.size;
+    }
+
+    bool IsEmpty() const noexcept {
+        return state_.size == 0;
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return ChunkFor(state_, index)[index & kMask];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if(index >= GetSize()) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return (*this)[index];
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(&state_, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(&state_, state_.size);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Возвращает версию, в которой элемент index заменён на value
+    [[nodiscard]] PersistentSimpleVector Set(size_t index, Type value) const {
+        assert(index < GetSize());
+        State next = state_;
+        SetAt(next, 0, index, std::move(value));
+        return PersistentSimpleVector(std::move(next));
+    }
+
+    // Возвращает версию с value в конце
+    [[nodiscard]] PersistentSimpleVector PushBack(Type value) const {
+        State next = state_;
+        Push(next, 0, std::move(value));
+        return PersistentSimpleVector(std::move(next));
+    }
+
+    // Возвращает версию без последнего элемента
+    [[nodiscard]] PersistentSimpleVector PopBack() const {
+        assert(!IsEmpty());
+        State next = state_;
+        Pop(next, 0);
+        return PersistentSimpleVector(std::move(next));
+    }
+
+    // Возвращает версию с элементами other в конце. Узлы этого вектора разделяются,
+    // а элементы other копируются блоками: O(other.GetSize())
+    [[nodiscard]] PersistentSimpleVector Concat(const PersistentSimpleVector& other) const {
+        State next = state_;
+        const uint64_t owner = NextOwner();
+        for(size_t first = 0; first < other.GetSize(); first += kWidth) {
+            const Type* chunk = ChunkFor(other.state_, first);
+            AppendRange(next, owner, chunk, chunk + std::min(kWidth, other.GetSize() - first));
+        }
+        return PersistentSimpleVector(std::move(next));
+    }
+
+    // Копирует элементы в обычный вектор блоками по 32
+    SimpleVector<Type> ToSimpleVector() const {
+        SimpleVector<Type> result(Reserve(GetSize()));
+        for(size_t first = 0; first < GetSize(); first += kWidth) {
+            const Type* chunk = ChunkFor(state_, first);
+            result.Append(chunk, chunk + std::min(kWidth, GetSize() - first));
+        }
+        return result;
+    }
+
+    Transient ToTransient() const {
+        return Transient(*this);
+    }
+
+    void swap(PersistentSimpleVector& other) noexcept {
+        std::swap(state_, other.state_);
+    }
+
+private:
+    explicit PersistentSimpleVector(State state) noexcept
+        : state_(std::move(state)) {
+    }
+
+    // Уникальный номер владельца: номера не переиспользуются, поэтому узлы завершённого
+    // построения (в том числе с одноразовым номером в конструкторах и Concat) больше никто не изменит
+    static uint64_t NextOwner() noexcept {
+        static std::atomic<uint64_t> next_owner{1};
+        return next_owner.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static size_t TailOffset(size_t size) noexcept {
+        return size < kWidth ? 0 : ((size - 1) >> kBits) << kBits;
+    }
+
+    // Начало листа, в котором лежит элемент index
+    static const Type* ChunkFor(const State& state, size_t index) noexcept {
+        if(index >= TailOffset(state.size)) {
+            return state.tail->values.begin();
+        }
+        const Node* node = state.root.get();
+        for(size_t level = state.shift; level > 0; level -= kBits) {
+            node = static_cast<const Branch*>(node)->children[(index >> level) & kMask].get();
+        }
+        return static_cast<const Leaf*>(node)->values.begin();
+    }
+
+    // Возвращает узел, который можно менять: свой узел владельца или его копию
+    template <typename NodeType>
+    static std::shared_ptr<NodeType> Editable(const std::shared_ptr<NodeType>& node, uint64_t owner) {
+        if(owner != 0 && node->owner == owner) {
+            return node;
+        }
+        auto copy = std::make_shared<NodeType>(*node);
+        copy->owner = owner;
+        return copy;
+    }
+
+    static NodePtr NewPath(size_t level, std::shared_ptr<Leaf> leaf, uint64_t owner) {
+        if(level == 0) {
+            return leaf;
+        }
+        auto branch = std::make_shared<Branch>(owner);
+        branch->children[0] = NewPath(level - kBits, std::move(leaf), owner);
+        return branch;
+    }
+
+    // Переносит заполненный хвост в дерево
+    static void PushTail(State& state, uint64_t owner) {
+        if(!state.root) {
+            state.root = std::make_shared<Branch>(owner);
+            state.shift = kBits;
+        }
+        if((state.size >> kBits) > (size_t(1) << state.shift)) {
+            auto root = std::make_shared<Branch>(owner);
+            root->children[0] = state.root;
+            root->children[1] = NewPath(state.shift, state.tail, owner);
+            state.root = std::move(root);
+            state.shift += kBits;
+        } else {
+            state.root = PushTail(state, state.root, state.shift, owner);
+        }
+    }
+
+    static std::shared_ptr<Branch> PushTail(const State& state, const std::shared_ptr<Branch>& parent, size_t level, uint64_t owner) {
+        auto branch = Editable(parent, owner);
+        NodePtr& child = branch->children[((state.size - 1) >> level) & kMask];
+        if(level == kBits) {
+            child = state.tail;
+        } else if(child) {
+            child = PushTail(state, std::static_pointer_cast<Branch>(child), level - kBits, owner);
+        } else {
+            child = NewPath(level - kBits, state.tail, owner);
+        }
+        return branch;
+    }
+
+    static void Push(State& state, uint64_t owner, Type&& value) {
+        if(state.tail && state.size - TailOffset(state.size) < kWidth) {
+            state.tail = Editable(state.tail, owner);
+            state.tail->values.PushBack(std::move(value));
+        } else {
+            auto tail = std::make_shared<Leaf>(owner);
+            tail->values.PushBack(std::move(value));
+            if(state.tail) {
+                PushTail(state, owner);
+            }
+            state.tail = std::move(tail);
+        }
+        ++state.size;
+    }
+
+    // Дописывает [first, last), заполняя хвост целыми блоками для итераторов произвольного доступа
+    template <typename InputIt>
+    static void AppendRange(State& state, uint64_t owner, InputIt first, InputIt last) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        while(first != last) {
+            const size_t in_tail = state.size - TailOffset(state.size);
+            if constexpr(std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+                if(state.tail && in_tail < kWidth) {
+                    const size_t count = std::min(kWidth - in_tail, static_cast<size_t>(last - first));
+                    state.tail = Editable(state.tail, owner);
+                    state.tail->values.Append(first, first + count);
+                    state.size += count;
+                    first += count;
+                    continue;
+                }
+            }
+            Push(state, owner, Type(*first));
+            ++first;
+        }
+    }
+
+    static void SetAt(State& state, uint64_t owner, size_t index, Type&& value) {
+        if(index >= TailOffset(state.size)) {
+            state.tail = Editable(state.tail, owner);
+            state.tail->values[index & kMask] = std::move(value);
+        } else {
+            state.root = SetAt(state.root, state.shift, owner, index, std::move(value));
+        }
+    }
+
+    static std::shared_ptr<Branch> SetAt(const std::shared_ptr<Branch>& parent, size_t level, uint64_t owner, size_t index, Type&& value) {
+        auto branch = Editable(parent, owner);
+        NodePtr& child = branch->children[(index >> level) & kMask];
+        if(level == kBits) {
+            auto leaf = Editable(std::static_pointer_cast<Leaf>(child), owner);
+            leaf->values[index & kMask] = std::move(value);
+            child = std::move(leaf);
+        } else {
+            child = SetAt(std::static_pointer_cast<Branch>(child), level - kBits, owner, index, std::move(value));
+        }
+        return branch;
+    }
+
+    static void Pop(State& state, uint64_t owner) {
+        if(state.size == 1) {
+            state = State();
+            return;
+        }
+        if(state.size - TailOffset(state.size) > 1) {
+            state.tail = Editable(state.tail, owner);
+            state.tail->values.PopBack();
+            --state.size;
+            return;
+        }
+        // В хвосте один элемент: хвостом становится последний лист дерева
+        NodePtr node = state.root;
+        for(size_t level = state.shift; level > 0; level -= kBits) {
+            node = static_cast<const Branch&>(*node).children[((state.size - 2) >> level) & kMask];
+        }
+        auto root = PopTail(state, state.root, state.shift, owner);
+        if(root && state.shift > kBits && !root->children[1]) {
+            root = std::static_pointer_cast<Branch>(root->children[0]);
+            state.shift -= kBits;
+        }
+        state.root = std::move(root);
+        state.tail = std::static_pointer_cast<Leaf>(std::move(node));
+        --state.size;
+    }
+
+    // Убирает из дерева последний лист; возвращает nullptr, если узел опустел
+    static std::shared_ptr<Branch> PopTail(const State& state, const std::shared_ptr<Branch>& parent, size_t level, uint64_t owner) {
+        const size_t child_index = ((state.size - 2) >> level) & kMask;
+        NodePtr child;
+        if(level > kBits) {
+            child = PopTail(state, std::static_pointer_cast<Branch>(parent->children[child_index]), level - kBits, owner);
+        }
+        if(!child && child_index == 0) {
+            return nullptr;
+        }
+        auto branch = Editable(parent, owner);
+        branch->children[child_index] = std::move(child);
+        return branch;
+    }
+
+    State state_;
+};
+
+// Построитель версий: изменяет вектор на месте, копируя только узлы, общие
+// с другими версиями; свои узлы правятся без копирования. Persistent() возвращает
+// неизменяемую версию за O(1), после чего построитель можно продолжать использовать:
+// узлы, отданные версии, он больше не меняет.
+// Один Transient нельзя изменять из нескольких потоков одновременно
+template <typename Type>
+class PersistentSimpleVector<Type>::Transient {
+public:
+    Transient() noexcept
+        : owner_(NextOwner()) {
+    }
+
+    explicit Transient(const PersistentSimpleVector& vector) noexcept
+        : state_(vector.state_), owner_(NextOwner()) {
+    }
+
+    Transient(const Transient&) = delete;
+    Transient& operator=(const Transient&) = delete;
+
+    // Перемещённый построитель получает новый номер владельца и пуст
+    Transient(Transient&& other) noexcept
+        : state_(std::move(other.state_)), owner_(std::exchange(other.owner_, NextOwner())) {
+    }
+
+    Transient& operator=(Transient&& rhs) noexcept {
+        if(this != &rhs) {
+            state_ = std::move(rhs.state_);
+            owner_ = std::exchange(rhs.owner_, NextOwner());
+        }
+        return *this;
+    }
+
+    size_t GetSize() const noexcept {
+        return state_.size;
+    }
+
+    bool IsEmpty() const noexcept {
+        return state_.size == 0;
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return ChunkFor(state_, index)[index & kMask];
+    }
+
+    Transient& Set(size_t index, Type value) {
+        assert(index < GetSize());
+        SetAt(state_, owner_, index, std::move(value));
+        return *this;
+    }
+
+    Transient& PushBack(Type value) {
+        Push(state_, owner_, std::move(value));
+        return *this;
+    }
+
+    Transient& PopBack() {
+        assert(!IsEmpty());
+        Pop(state_, owner_);
+        return *this;
+    }
+
+    // Дописывает элементы [first, last); из итераторов произвольного доступа хвост заполняется блоками
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    Transient& Append(InputIt first, InputIt last) {
+        AppendRange(state_, owner_, first, last);
+        return *this;
+    }
+
+    // Возвращает неизменяемую версию текущего состояния
+    PersistentSimpleVector Persistent() {
+        owner_ = NextOwner();
+        return PersistentSimpleVector(state_);
+    }
+
+private:
+    State state_;
+    uint64_t owner_;
+};
+
+template <typename Type>
+bool operator==(const PersistentSimpleVector<Type>& lhs, const PersistentSimpleVector<Type>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type>
+bool operator!=(const PersistentSimpleVector<Type>& lhs, const PersistentSimpleVector<Type>& rhs) {
+    return !(lhs == rhs);
+}
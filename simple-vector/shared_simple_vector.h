@@ -0,0 +1,310 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+// Вектор с копированием при записи: копии за O(1) делят один буфер со счётчиком ссылок.
+// Первый изменяющий вызов (неконстантные operator[], At, begin/end, PushBack, Insert,
+// Erase, Resize и т.д.) у разделённого вектора сначала копирует буфер себе.
+// Чтение через константный объект буфер не копирует, поэтому снимки удобно
+// раздавать как const SharedSimpleVector&.
+//
+// Неконстантные operator[], At, begin/end, EmplaceBack, Insert и Erase отдают ссылку или
+// итератор, через которые буфер можно изменить позже. После этого буфер помечается
+// неразделяемым: копии такого вектора копируют элементы сразу, иначе запись через
+// сохранённую ссылку изменила бы и копию. Пометка снимается вызовом Freeze(), после
+// которого выданные ссылки использовать нельзя, или когда вектор получает другой буфер
+// (присваивание, swap, Clear разделённого буфера). Поэтому читать лучше через
+// const-объект или cbegin/cend, а после заполнения через ссылки вызывать Freeze().
+//
+// Счётчик ссылок атомарный, проверка единственности владения читает его с memory_order_acquire:
+// копии одного вектора можно читать и изменять в разных потоках, запись в отделённый буфер
+// не гонится с чтением других владельцев, отпустивших его. Один объект SharedSimpleVector,
+// как и SimpleVector, из нескольких потоков одновременно не изменяется
+template <typename Type>
+class SharedSimpleVector {
+public:
+    using Vector = SimpleVector<Type>;
+    using Iterator = typename Vector::Iterator;
+    using ConstIterator = typename Vector::ConstIterator;
+
+    SharedSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SharedSimpleVector(size_t size)
+        : buffer_(new Buffer(size)) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SharedSimpleVector(size_t size, const Type& value)
+        : buffer_(new Buffer(size, value)) {
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SharedSimpleVector(std::initializer_list<Type> init)
+        : buffer_(new Buffer(init)) {
+    }
+
+    // Забирает буфер обычного вектора без копирования элементов
+    explicit SharedSimpleVector(Vector&& vector)
+        : buffer_(new Buffer(std::move(vector))) {
+    }
+
+    // Копия делит буфер с other, если тот не помечен неразделяемым
+    SharedSimpleVector(const SharedSimpleVector& other)
+        : buffer_(other.unshareable_ ? new Buffer(other.buffer_->vector) : Share(other.buffer_)) {
+    }
+
+    SharedSimpleVector& operator=(const SharedSimpleVector& rhs) {
+        if(this != &rhs) {
+            SharedSimpleVector(rhs).swap(*this);
+        }
+        return *this;
+    }
+
+    SharedSimpleVector(SharedSimpleVector&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, nullptr)), unshareable_(std::exchange(other.unshareable_, false)) {
+    }
+
+    SharedSimpleVector& operator=(SharedSimpleVector&& rhs) noexcept {
+        if(this != &rhs) {
+            SharedSimpleVector(std::move(rhs)).swap(*this);
+        }
+        return *this;
+    }
+
+    ~SharedSimpleVector() {
+        Release(buffer_);
+    }
+
+    // Обычный вектор с содержимым; пока буфер разделён, менять его нельзя
+    const Vector& Get() const noexcept {
+        return buffer_ ? buffer_->vector : Empty();
+    }
+
+    // Возвращает true, если буфер разделён с другими копиями
+    bool IsShared() const noexcept {
+        return buffer_ && buffer_->refs.load(std::memory_order_acquire) > 1;
+    }
+
+    // Возвращает true, если копии этого вектора копируют элементы, а не делят буфер
+    bool IsUnshareable() const noexcept {
+        return unshareable_;
+    }
+
+    // Завершает изменение через ссылки: следующие копии снова делят буфер за O(1).
+    // Ссылки и итераторы, полученные раньше через неконстантные operator[], At, begin/end,
+    // EmplaceBack, Insert и Erase, после этого недействительны: запись через них
+    // изменила бы и копии
+    void Freeze() noexcept {
+        unshareable_ = false;
+    }
+
+    size_t GetSize() const noexcept {
+        return Get().GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return Get().GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return Get().IsEmpty();
+    }
+
+    // Возвращает ссылку на элемент для изменения, отделяя буфер
+    Type& operator[](size_t index) {
+        assert(index < GetSize());
+        return DetachWritable()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return Get()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size. Отделяет буфер
+    Type& At(size_t index) {
+        Get().At(index);
+        return DetachWritable()[index];
+    }
+
+    const Type& At(size_t index) const {
+        return Get().At(index);
+    }
+
+    // Неконстантные итераторы отделяют буфер
+    Iterator begin() {
+        return DetachWritable().begin();
+    }
+
+    Iterator end() {
+        return DetachWritable().end();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Get().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return Get().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Get().cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Get().cend();
+    }
+
+    // PushBack ссылку не отдаёт, поэтому буфер остаётся разделяемым
+    void PushBack(const Type& item) {
+        Detach().PushBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        Detach().PushBack(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return DetachWritable().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Вставляет значение перед pos. pos может указывать в разделённый буфер:
+    // позиция запоминается до отделения
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        const size_t index = pos - cbegin();
+        Vector& vector = DetachWritable();
+        return vector.Insert(vector.cbegin() + index, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        const size_t index = pos - cbegin();
+        Vector& vector = DetachWritable();
+        return vector.Insert(vector.cbegin() + index, std::move(value));
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos - cbegin();
+        Vector& vector = DetachWritable();
+        return vector.Erase(vector.cbegin() + index);
+    }
+
+    void PopBack() {
+        Detach().PopBack();
+    }
+
+    void Resize(size_t new_size) {
+        Detach().Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        Detach().Reserve(new_capacity);
+    }
+
+    // Разделённый буфер не копируется: вектор просто отпускает его
+    void Clear() noexcept {
+        if(IsShared()) {
+            Release(std::exchange(buffer_, nullptr));
+            unshareable_ = false;
+        } else if(buffer_) {
+            buffer_->vector.Clear();
+        }
+    }
+
+    void swap(SharedSimpleVector& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        std::swap(unshareable_, other.unshareable_);
+    }
+
+private:
+    // Буфер со встроенным счётчиком владельцев
+    struct Buffer {
+        template <typename... Args>
+        explicit Buffer(Args&&... args)
+            : vector(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs{1};
+        Vector vector;
+    };
+
+    static Buffer* Share(Buffer* buffer) noexcept {
+        if(buffer) {
+            buffer->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return buffer;
+    }
+
+    // Последний владелец удаляет буфер; acq_rel упорядочивает удаление после
+    // всех обращений других владельцев
+    static void Release(Buffer* buffer) noexcept {
+        if(buffer && buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete buffer;
+        }
+    }
+
+    static const Vector& Empty() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    // Делает буфер собственным: пустой создаётся, разделённый копируется.
+    // acquire-чтение счётчика синхронизируется с Release других владельцев,
+    // поэтому их чтения буфера завершены до нашей записи в него
+    Vector& Detach() {
+        if(!buffer_) {
+            buffer_ = new Buffer();
+        } else if(buffer_->refs.load(std::memory_order_acquire) > 1) {
+            Buffer* copy = new Buffer(buffer_->vector);
+            Release(std::exchange(buffer_, copy));
+        }
+        return buffer_->vector;
+    }
+
+    // Отделяет буфер перед выдачей изменяемой ссылки или итератора и помечает его неразделяемым
+    Vector& DetachWritable() {
+        Vector& vector = Detach();
+        unshareable_ = true;
+        return vector;
+    }
+
+    Buffer* buffer_ = nullptr;
+    bool unshareable_ = false;
+};
+
+template <typename Type>
+inline bool operator==(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return lhs.Get() == rhs.Get();
+}
+
+template <typename Type>
+inline bool operator!=(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type>
+inline bool operator<(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return lhs.Get() < rhs.Get();
+}
+
+template <typename Type>
+inline bool operator<=(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return lhs.Get() <= rhs.Get();
+}
+
+template <typename Type>
+inline bool operator>(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type>
+inline bool operator>=(const SharedSimpleVector<Type>& lhs, const SharedSimpleVector<Type>& rhs) {
+    return lhs.Get() >= rhs.Get();
+}
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Векторные ядра сравнения и поиска для массивов арифметических типов.
+// Ядра написаны на векторных расширениях GCC/Clang: на x86 одна и та же функция
+// собирается под SSE2 (16 байт) и под AVX2 (32 байта), а нужная версия выбирается
+// при первом вызове по __builtin_cpu_supports. На других архитектурах используются
+// 16-байтные векторы базового набора инструкций (например, NEON), на прочих
+// компиляторах - обычные циклы. SIMPLE_VECTOR_NO_SIMD отключает векторизацию.
+// Поиск и равенство векторизуются для целых и чисел с плавающей точкой,
+// упорядочивающие ядра (сравнение, Min, Max, Sum) - только для целых: порядок
+// сложения и обработка NaN у чисел с плавающей точкой должны остаться прежними.
+
+#if !defined(SIMPLE_VECTOR_NO_SIMD) && defined(__GNUC__)
+#define SIMPLE_VECTOR_SIMD 1
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMPLE_VECTOR_SIMD_DISPATCH 1
+#endif
+#endif
+
+namespace simd {
+
+// Элементы сравниваются на равенство векторно
+template <typename Type>
+inline constexpr bool kVectorizable = std::is_arithmetic_v<Type> && !std::is_same_v<Type, bool>
+                                      && sizeof(Type) <= 8 && (sizeof(Type) & (sizeof(Type) - 1)) == 0;
+
+// Элементы упорядочиваются и складываются векторно
+template <typename Type>
+inline constexpr bool kVectorizableOrdered = kVectorizable<Type> && std::is_integral_v<Type>;
+
+#ifdef SIMPLE_VECTOR_SIMD
+
+// Векторы передаются только между встраиваемыми функциями, поэтому
+// предупреждение о смене ABI для 32-байтных векторов без AVX не относится к делу
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template <size_t Bytes, typename Type>
+struct Kernels {
+    using Vec [[gnu::vector_size(Bytes)]] = Type;
+    using Mask = decltype(Vec{} == Vec{});
+    static constexpr size_t kLanes = Bytes / sizeof(Type);
+
+    [[gnu::always_inline]] static inline Vec Load(const Type* data) noexcept {
+        Vec vec;
+        std::memcpy(&vec, data, Bytes);
+        return vec;
+    }
+
+    [[gnu::always_inline]] static inline bool Any(const Mask& mask) noexcept {
+        uint64_t words[Bytes / 8];
+        std::memcpy(words, &mask, Bytes);
+        uint64_t any = 0;
+        for(uint64_t word : words) {
+            any |= word;
+        }
+        return any != 0;
+    }
+
+    [[gnu::always_inline]] static inline size_t Mismatch(const Type* lhs, const Type* rhs, size_t size) noexcept {
+        size_t i = 0;
+        while(i + kLanes <= size && !Any(Load(lhs + i) != Load(rhs + i))) {
+            i += kLanes;
+        }
+        // Точная позиция внутри блока с расхождением или в хвосте
+        while(i < size && lhs[i] == rhs[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    [[gnu::always_inline]] static inline size_t Find(const Type* data, size_t size, Type value) noexcept {
+        const Vec needle = Vec{} + value;
+        size_t i = 0;
+        while(i + kLanes <= size && !Any(Load(data + i) == needle)) {
+            i += kLanes;
+        }
+        while(i < size && !(data[i] == value)) {
+            ++i;
+        }
+        return i;
+    }
+
+    [[gnu::always_inline]] static inline size_t Count(const Type* data, size_t size, Type value) noexcept {
+        // Совпадение даёт в маске -1, поэтому счётчики в дорожках растут вычитанием маски.
+        // Узкие дорожки сбрасываются в общий счётчик раньше, чем переполнятся
+        constexpr size_t kMaxBlocks = sizeof(Type) == 1 ? 127 : sizeof(Type) == 2 ? 32767 : size_t{1} << 30;
+        const Vec needle = Vec{} + value;
+        size_t count = 0;
+        size_t i = 0;
+        while(i + kLanes <= size) {
+            Mask lanes{};
+            for(size_t blocks = 0; blocks < kMaxBlocks && i + kLanes <= size; ++blocks, i += kLanes) {
+                lanes -= Load(data + i) == needle;
+            }
+            for(size_t lane = 0; lane < kLanes; ++lane) {
+                count += static_cast<size_t>(lanes[lane]);
+            }
+        }
+        for(; i < size; ++i) {
+            count += data[i] == value;
+        }
+        return count;
+    }
+
+    template <bool kMin>
+    [[gnu::always_inline]] static inline Type MinMax(const Type* data, size_t size) noexcept {
+        Type result = data[0];
+        size_t i = 0;
+        if(size >= kLanes) {
+            Vec acc = Load(data);
+            for(i = kLanes; i + kLanes <= size; i += kLanes) {
+                const Vec vec = Load(data + i);
+                acc = (kMin ? vec < acc : acc < vec) ? vec : acc;
+            }
+            for(size_t lane = 0; lane < kLanes; ++lane) {
+                result = kMin ? std::min(result, acc[lane]) : std::max(result, acc[lane]);
+            }
+        }
+        for(; i < size; ++i) {
+            result = kMin ? std::min(result, data[i]) : std::max(result, data[i]);
+        }
+        return result;
+    }
+
+    [[gnu::always_inline]] static inline Type Min(const Type* data, size_t size) noexcept {
+        return MinMax<true>(data, size);
+    }
+
+    [[gnu::always_inline]] static inline Type Max(const Type* data, size_t size) noexcept {
+        return MinMax<false>(data, size);
+    }
+
+    [[gnu::always_inline]] static inline Type Sum(const Type* data, size_t size) noexcept {
+        // Сложение по модулю 2^n, как у обычного цикла с приведением к Type
+        using Unsigned = std::make_unsigned_t<Type>;
+        using UnsignedVec [[gnu::vector_size(Bytes)]] = Unsigned;
+        UnsignedVec acc{};
+        size_t i = 0;
+        for(; i + kLanes <= size; i += kLanes) {
+            UnsignedVec vec;
+            std::memcpy(&vec, data + i, Bytes);
+            acc += vec;
+        }
+        Unsigned sum = 0;
+        for(size_t lane = 0; lane < kLanes; ++lane) {
+            sum += acc[lane];
+        }
+        for(; i < size; ++i) {
+            sum += static_cast<Unsigned>(data[i]);
+        }
+        return static_cast<Type>(sum);
+    }
+};
+
+#pragma GCC diagnostic pop
+
+#ifdef SIMPLE_VECTOR_SIMD_DISPATCH
+
+inline bool HasAvx2() noexcept {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+// Ядро Name собирается дважды: под AVX2 и под базовый SSE2
+#define SIMPLE_VECTOR_SIMD_KERNEL(Name, Result, Params, Args)                      \
+    template <typename Type>                                                       \
+    [[gnu::target("avx2")]] Result Name##Avx2 Params noexcept {                    \
+        return Kernels<32, Type>::Name Args;                                       \
+    }                                                                              \
+    template <typename Type>                                                       \
+    [[gnu::target("sse2")]] Result Name##Sse2 Params noexcept {                    \
+        return Kernels<16, Type>::Name Args;                                       \
+    }                                                                              \
+    template <typename Type>                                                       \
+    Result Name##Kernel Params noexcept {                                          \
+        return HasAvx2() ? Name##Avx2<Type> Args : Name##Sse2<Type> Args;          \
+    }
+
+#else
+
+#define SIMPLE_VECTOR_SIMD_KERNEL(Name, Result, Params, Args)                      \
+    template <typename Type>                                                       \
+    Result Name##Kernel Params noexcept {                                          \
+        return Kernels<16, Type>::Name Args;                                       \
+    }
+
+#endif
+
+SIMPLE_VECTOR_SIMD_KERNEL(Mismatch, size_t, (const Type* lhs, const Type* rhs, size_t size), (lhs, rhs, size))
+SIMPLE_VECTOR_SIMD_KERNEL(Find, size_t, (const Type* data, size_t size, Type value), (data, size, value))
+SIMPLE_VECTOR_SIMD_KERNEL(Count, size_t, (const Type* data, size_t size, Type value), (data, size, value))
+SIMPLE_VECTOR_SIMD_KERNEL(Min, Type, (const Type* data, size_t size), (data, size))
+SIMPLE_VECTOR_SIMD_KERNEL(Max, Type, (const Type* data, size_t size), (data, size))
+SIMPLE_VECTOR_SIMD_KERNEL(Sum, Type, (const Type* data, size_t size), (data, size))
+
+#undef SIMPLE_VECTOR_SIMD_KERNEL
+
+#endif
+
+// Индекс первого расхождения lhs и rhs длины size, либо size
+template <typename Type>
+size_t Mismatch(const Type* lhs, const Type* rhs, size_t size) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizable<Type>) {
+        return MismatchKernel(lhs, rhs, size);
+    }
+#endif
+    return std::mismatch(lhs, lhs + size, rhs).first - lhs;
+}
+
+// Равенство массивов длины lhs_size и rhs_size
+template <typename Type>
+bool Equal(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    return lhs_size == rhs_size && Mismatch(lhs, rhs, lhs_size) == lhs_size;
+}
+
+// Лексикографическое сравнение за один проход: отрицательное число, если lhs < rhs,
+// ноль, если ни один не меньше другого, положительное, если lhs > rhs.
+// Использует только operator<, как std::lexicographical_compare
+template <typename Type>
+int Compare(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    const size_t common = std::min(lhs_size, rhs_size);
+    if constexpr(kVectorizableOrdered<Type>) {
+        const size_t i = Mismatch(lhs, rhs, common);
+        if(i != common) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    } else {
+        for(size_t i = 0; i < common; ++i) {
+            if(lhs[i] < rhs[i]) {
+                return -1;
+            }
+            if(rhs[i] < lhs[i]) {
+                return 1;
+            }
+        }
+    }
+    return lhs_size < rhs_size ? -1 : lhs_size > rhs_size ? 1 : 0;
+}
+
+// Индекс первого элемента, равного value, либо size
+template <typename Type>
+size_t Find(const Type* data, size_t size, const Type& value) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizable<Type>) {
+        return FindKernel(data, size, value);
+    }
+#endif
+    return std::find(data, data + size, value) - data;
+}
+
+// Количество элементов, равных value
+template <typename Type>
+size_t Count(const Type* data, size_t size, const Type& value) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizable<Type>) {
+        return CountKernel(data, size, value);
+    }
+#endif
+    return std::count(data, data + size, value);
+}
+
+// Наименьший элемент непустого массива
+template <typename Type>
+Type Min(const Type* data, size_t size) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizableOrdered<Type>) {
+        return MinKernel(data, size);
+    }
+#endif
+    return *std::min_element(data, data + size);
+}
+
+// Наибольший элемент непустого массива
+template <typename Type>
+Type Max(const Type* data, size_t size) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizableOrdered<Type>) {
+        return MaxKernel(data, size);
+    }
+#endif
+    return *std::max_element(data, data + size);
+}
+
+// Сумма элементов, начиная с Type{}
+template <typename Type>
+Type Sum(const Type* data, size_t size) {
+#ifdef SIMPLE_VECTOR_SIMD
+    if constexpr(kVectorizableOrdered<Type>) {
+        return SumKernel(data, size);
+    }
+#endif
+    Type sum{};
+    for(size_t i = 0; i < size; ++i) {
+        sum = sum + data[i];
+    }
+    return sum;
+}
+
+// Сдвигает к началу элементы, для которых pred ложен, сохраняя их порядок;
+// возвращает их количество. Для арифметических типов - без ветвлений: pred считается
+// для блока элементов в массив признаков (такой цикл компилятор векторизует, если pred прост),
+// затем каждый элемент записывается на место, а позиция записи сдвигается на его признак
+template <typename Type, typename Pred>
+size_t RemoveIf(Type* data, size_t size, Pred pred) {
+    if constexpr(kVectorizable<Type>) {
+        constexpr size_t kBlock = 256;
+        bool keep[kBlock];
+        size_t kept = 0;
+        for(size_t first = 0; first < size; first += kBlock) {
+            const size_t count = std::min(kBlock, size - first);
+            for(size_t i = 0; i < count; ++i) {
+                keep[i] = !pred(data[first + i]);
+            }
+            for(size_t i = 0; i < count; ++i) {
+                data[kept] = data[first + i];
+                kept += keep[i];
+            }
+        }
+        return kept;
+    } else {
+        return std::remove_if(data, data + size, pred) - data;
+    }
+}
+
+} // namespace simd
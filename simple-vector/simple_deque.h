@@ -0,0 +1,634 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Двусторонняя очередь в одном непрерывном кольцевом буфере, вместимость которого -
+// степень двойки: логический индекс переводится в ячейку буфера маской, без деления.
+// PushFront, PopFront, PushBack и PopBack - O(1) (рост - амортизированно),
+// Insert и Erase сдвигают ту сторону, которая короче.
+// Linearize() делает элементы непрерывными (обычно без выделения памяти)
+// и возвращает указатель на первый, например для векторизованных циклов
+template <typename Type, typename Alloc = std::allocator<Type>>
+class SimpleDeque {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    template <bool kConst>
+    class DequeIterator {
+        using Owner = std::conditional_t<kConst, const SimpleDeque, SimpleDeque>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, const Type&, Type&>;
+        using pointer = std::conditional_t<kConst, const Type*, Type*>;
+
+        DequeIterator() = default;
+
+        DequeIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        // Константный итератор из неконстантного
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        DequeIterator(const DequeIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        DequeIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        DequeIterator operator++(int) noexcept {
+            DequeIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        DequeIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        DequeIterator operator--(int) noexcept {
+            DequeIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        DequeIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        DequeIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend DequeIterator operator+(DequeIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend DequeIterator operator+(difference_type offset, DequeIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend DequeIterator operator-(DequeIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator<=(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>=(const DequeIterator& lhs, const DequeIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        friend class DequeIterator<!kConst>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Iterator = DequeIterator<false>;
+    using ConstIterator = DequeIterator<true>;
+    using Allocator = Alloc;
+    using Items = ArrayPtr<Type, Alloc>;
+
+    SimpleDeque() noexcept(noexcept(Alloc())) = default;
+
+    // Создаёт пустую очередь, память которой будет выделяться аллокатором alloc
+    explicit SimpleDeque(const Alloc& alloc) noexcept
+        : items_(alloc) {
+    }
+
+    // Создаёт очередь из size элементов, инициализированных значением по умолчанию
+    explicit SimpleDeque(size_t size, const Alloc& alloc = Alloc())
+        : items_(alloc) {
+        Fill([&] {
+            Resize(size);
+        });
+    }
+
+    // Создаёт очередь из size элементов, инициализированных значением value
+    SimpleDeque(size_t size, const Type& value, const Alloc& alloc = Alloc())
+        : items_(alloc) {
+        Fill([&] {
+            Reserve(size);
+            while(size_ < size) {
+                EmplaceBack(value);
+            }
+        });
+    }
+
+    // Создаёт очередь из std::initializer_list
+    SimpleDeque(std::initializer_list<Type> init, const Alloc& alloc = Alloc())
+        : SimpleDeque(init.begin(), init.end(), alloc) {
+    }
+
+    // Создаёт очередь из диапазона [first, last)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    SimpleDeque(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : items_(alloc) {
+        Fill([&] {
+            Append(first, last);
+        });
+    }
+
+    //Копирующий конструктор
+    SimpleDeque(const SimpleDeque& other)
+        : items_(AllocTraits::select_on_container_copy_construction(other.items_.GetAllocator())) {
+        Fill([&] {
+            Append(other.begin(), other.end());
+        });
+    }
+
+    //Копирующее присваивание
+    SimpleDeque& operator=(const SimpleDeque& rhs) {
+        if(this != &rhs) {
+            SimpleDeque temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    //Перемещающий конструктор
+    SimpleDeque(SimpleDeque&& other) noexcept
+        : items_(std::move(other.items_)) {
+        head_ = std::exchange(other.head_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    //Перемещающее присваивание: забирает буфер rhs. Необмениваемые аллокаторы должны быть равны
+    SimpleDeque& operator=(SimpleDeque&& rhs) noexcept {
+        if(this != &rhs) {
+            SimpleDeque temp(std::move(rhs));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~SimpleDeque() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return items_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с логическим индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return items_[Physical(index)];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return items_[Physical(index)];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        CheckIndex(index);
+        return (*this)[index];
+    }
+
+    const Type& At(size_t index) const {
+        CheckIndex(index);
+        return (*this)[index];
+    }
+
+    Type& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const Type& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    Type& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const Type& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    void Clear() noexcept {
+        while(size_ != 0) {
+            PopBack();
+        }
+        head_ = 0;
+    }
+
+    // Изменяет размер, новые элементы в конце инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        while(size_ < new_size) {
+            EmplaceBack();
+        }
+        while(size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    // Вместимость округляется вверх до степени двойки. Если она не помещается в size_t,
+    // выбрасывает std::length_error
+    void Reserve(size_t new_capacity) {
+        if(new_capacity > GetCapacity()) {
+            Reallocate(RoundUpToPowerOfTwo(new_capacity));
+        }
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    void PushFront(const Type& item) {
+        EmplaceFront(item);
+    }
+
+    void PushFront(Type&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    // Создаёт элемент в конце очереди. При росте элемент создаётся до переноса,
+    // поэтому args могут ссылаться на элементы самой очереди
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if(size_ == GetCapacity()) {
+            Type item = vector_detail::Make<Type>(std::forward<Args>(args)...);
+            Grow();
+            return EmplaceBack(std::move(item));
+        }
+        Type* slot = items_.Get() + Physical(size_);
+        Construct(slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    // Создаёт элемент в начале очереди
+    template <typename... Args>
+    Type& EmplaceFront(Args&&... args) {
+        if(size_ == GetCapacity()) {
+            Type item = vector_detail::Make<Type>(std::forward<Args>(args)...);
+            Grow();
+            return EmplaceFront(std::move(item));
+        }
+        const size_t head = (head_ - 1) & Mask();
+        Type* slot = items_.Get() + head;
+        Construct(slot, std::forward<Args>(args)...);
+        head_ = head;
+        ++size_;
+        return *slot;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        AllocTraits::destroy(items_.GetAllocator(), items_.Get() + Physical(size_));
+    }
+
+    void PopFront() noexcept {
+        assert(size_ != 0);
+        AllocTraits::destroy(items_.GetAllocator(), items_.Get() + head_);
+        head_ = (head_ + 1) & Mask();
+        --size_;
+    }
+
+    // Создаёт элемент перед pos, сдвигая на одну позицию более короткую сторону.
+    // Возвращает итератор на созданный элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t index = pos.GetIndex();
+        assert(index <= size_);
+        if(index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return Iterator(this, index);
+        }
+        if(index == 0) {
+            EmplaceFront(std::forward<Args>(args)...);
+            return begin();
+        }
+        Type item = vector_detail::Make<Type>(std::forward<Args>(args)...);
+        if(size_ == GetCapacity()) {
+            Grow();
+        }
+        if(index < size_ - index) {
+            EmplaceFront(std::move(Front()));
+            std::move(begin() + 2, begin() + index + 1, begin() + 1);
+        } else {
+            EmplaceBack(std::move(Back()));
+            std::move_backward(begin() + index, end() - 2, end() - 1);
+        }
+        (*this)[index] = std::move(item);
+        return Iterator(this, index);
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Дописывает в конец элементы [first, last)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            Reserve(size_ + static_cast<size_t>(std::distance(first, last)));
+        }
+        for(; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    // Удаляет элемент в позиции pos, сдвигая более короткую сторону.
+    // Возвращает итератор на элемент, следовавший за удалённым
+    Iterator Erase(ConstIterator pos) {
+        const size_t index = pos.GetIndex();
+        assert(index < size_);
+        if(index < size_ - index - 1) {
+            std::move_backward(begin(), begin() + index, begin() + index + 1);
+            PopFront();
+        } else {
+            std::move(begin() + index + 1, end(), begin() + index);
+            PopBack();
+        }
+        return Iterator(this, index);
+    }
+
+    // Делает элементы непрерывными и возвращает указатель на первый: [result, result + GetSize()).
+    // Если элементы переходят через конец буфера, они переставляются на месте; память
+    // выделяется заново, только если перемещение Type может бросить исключение.
+    // Указатель действителен до следующего изменения очереди
+    Type* Linearize() {
+        if(head_ + size_ <= GetCapacity()) {
+            return items_.Get() + head_;
+        }
+        if constexpr(IsTriviallyRelocatableV<Type> || std::is_nothrow_move_constructible_v<Type>) {
+            Type* data = items_.Get();
+            const size_t front_part = GetCapacity() - head_;
+            const size_t back_part = size_ - front_part;
+            // Начальная часть переезжает через свободные ячейки вплотную к конечной,
+            // затем обе меняются местами. В заполненном буфере свободных ячеек нет
+            if constexpr(IsTriviallyRelocatableV<Type>) {
+                std::memmove(static_cast<void*>(data + back_part), data + head_, front_part * sizeof(Type));
+            } else if(back_part != head_) {
+                for(size_t i = 0; i < front_part; ++i) {
+                    Construct(data + back_part + i, std::move(data[head_ + i]));
+                    AllocTraits::destroy(items_.GetAllocator(), data + head_ + i);
+                }
+            }
+            std::rotate(data, data + back_part, data + size_);
+            head_ = 0;
+        } else {
+            Reallocate(GetCapacity());
+        }
+        return items_.Get();
+    }
+
+    void swap(SimpleDeque& other) noexcept {
+        items_.swap(other.items_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    size_t Mask() const noexcept {
+        return GetCapacity() - 1;
+    }
+
+    size_t Physical(size_t index) const noexcept {
+        return (head_ + index) & Mask();
+    }
+
+    // Выбрасывает std::length_error, если такой степени двойки нет среди size_t
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        constexpr size_t kMaxPowerOfTwo = SIZE_MAX / 2 + 1;
+        if(value > kMaxPowerOfTwo) {
+            throw std::length_error("SimpleDeque capacity is too large");
+        }
+        size_t result = 1;
+        while(result < value) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    void Grow() {
+        Reallocate(std::max<size_t>(GetCapacity() * 2, 1));
+    }
+
+    void CheckIndex(size_t index) const {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than deque size"s);
+        }
+    }
+
+    // Выполняет заполнение из конструктора: при исключении созданные элементы разрушаются
+    template <typename Body>
+    void Fill(Body body) {
+        try {
+            body();
+        } catch(...) {
+            Clear();
+            throw;
+        }
+    }
+
+    // Переносит элементы в новый буфер вместимостью new_capacity, начиная с ячейки 0.
+    // Как и в SimpleVector, тривиально переносимые типы копируются memcpy, остальные
+    // перемещаются, только если перемещение не бросает исключений; при исключении
+    // старый буфер остаётся нетронутым
+    void Reallocate(size_t new_capacity) {
+        Items temp(new_capacity, items_.GetAllocator());
+        Type* data = items_.Get();
+        const size_t front_part = std::min(size_, GetCapacity() - head_);
+        RelocateRange(data + head_, data + head_ + front_part, temp.Get());
+        try {
+            RelocateRange(data, data + size_ - front_part, temp.Get() + front_part);
+        } catch(...) {
+            Destroy(temp.Get(), temp.Get() + front_part);
+            throw;
+        }
+        DestroyRelocated(data + head_, data + head_ + front_part);
+        DestroyRelocated(data, data + size_ - front_part);
+        items_.swap(temp);
+        head_ = 0;
+    }
+
+    void RelocateRange(Type* first, Type* last, Type* dest) {
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            if(first != last) {
+                std::memcpy(static_cast<void*>(dest), first, (last - first) * sizeof(Type));
+            }
+        } else if constexpr(std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            ConstructFrom(std::make_move_iterator(first), std::make_move_iterator(last), dest);
+        } else {
+            ConstructFrom(first, last, dest);
+        }
+    }
+
+    void DestroyRelocated(Type* first, Type* last) noexcept {
+        if constexpr(!IsTriviallyRelocatableV<Type>) {
+            Destroy(first, last);
+        }
+    }
+
+    template <typename InputIt>
+    void ConstructFrom(InputIt first, InputIt last, Type* dest) {
+        Type* current = dest;
+        try {
+            for(; first != last; ++first, ++current) {
+                Construct(current, *first);
+            }
+        } catch(...) {
+            Destroy(dest, current);
+            throw;
+        }
+    }
+
+    // Создаёт элемент в ячейке raw через аллокатор.
+    // Агрегаты без подходящего конструктора создаются через {}
+    template <typename... Args>
+    void Construct(Type* raw, Args&&... args) {
+        if constexpr(std::is_constructible_v<Type, Args...>) {
+            AllocTraits::construct(items_.GetAllocator(), raw, std::forward<Args>(args)...);
+        } else {
+            new (raw) Type{std::forward<Args>(args)...};
+        }
+    }
+
+    void Destroy(Type* first, Type* last) noexcept {
+        for(; first != last; ++first) {
+            AllocTraits::destroy(items_.GetAllocator(), first);
+        }
+    }
+
+    Items items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+template <typename Type, typename Alloc>
+bool operator==(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type, typename Alloc>
+bool operator!=(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Alloc>
+bool operator<(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, typename Alloc>
+bool operator<=(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Alloc>
+bool operator>(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Alloc>
+bool operator>=(const SimpleDeque<Type, Alloc>& lhs, const SimpleDeque<Type, Alloc>& rhs) {
+    return !(lhs < rhs);
+}
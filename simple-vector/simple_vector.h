@@ -1,12 +1,35 @@
 #pragma once
 
 #include <cassert>
+#include <cstring>
 #include <initializer_list>
 #include "array_ptr.h"
+#include "growth_policy.h"
+#include "simd_kernels.h"
+#include "execution_policy.h"
+#include "simple_vector_traits.h"
+#include "simple_vector_stats.h"
 #include <stdexcept>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <utility>
 #include <iterator>
+#include <type_traits>
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
+
+// Тип можно переносить побайтовым копированием памяти: объект, скопированный memcpy
+// в новое место, полностью заменяет исходный, а исходный разрушать уже не нужно.
+// Верно для всех тривиально копируемых типов; для своих типов (например, владеющих
+// указателем на кучу) можно включить явно:
+// template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {};
+
+template <typename Type>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<Type>::value;
 
 class ReserveProxyObj {
 public:
@@ -27,75 +50,185 @@ ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
 }
 
-template <typename Type>
+// Вектор с пользовательским аллокатором Alloc. Поддерживаются аллокаторы с состоянием,
+// правила propagate_on_container_* из std::allocator_traits и std::pmr (см. pmr::SimpleVector).
+// Growth задаёт, как растёт вместимость (см. growth_policy.h)
+template <typename Type, typename Alloc = std::allocator<Type>, typename Growth = DoublingGrowth>
 class SimpleVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Stats = SimpleVectorStatsHook<SimpleVector>;
+
 public:
     using Iterator = Type*;
     using ConstIterator = const Type*;
-    using Items = ArrayPtr<Type>;
+    using Allocator = Alloc;
+    using GrowthPolicy = Growth;
+    using Items = ArrayPtr<Type, Alloc>;
 
-    SimpleVector() noexcept {
-        size_ = 0;
-        capacity_ = 0;
+    SimpleVector() noexcept(noexcept(Alloc())) = default;
+
+    // Создаёт пустой вектор, память которого будет выделяться аллокатором alloc
+    explicit SimpleVector(const Alloc& alloc) noexcept
+        : items_(alloc) {
     }
 
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size) : SimpleVector(size, Type{}) {}
+    explicit SimpleVector(size_t size, const Alloc& alloc = Alloc())
+        : items_(Allocate(size, alloc)) {
+        ConstructN(items_.Get(), size);
+        size_ = size;
+        capacity_ = size;
+    }
 
     // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value) {
+    SimpleVector(size_t size, const Type& value, const Alloc& alloc = Alloc())
+        : items_(Allocate(size, alloc)) {
+        ConstructN(items_.Get(), size, value);
+        size_ = size;
+        capacity_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию.
+    // С политикой Parallel() элементы создаются на пуле потоков
+    SimpleVector(ExecutionPolicy policy, size_t size, const Alloc& alloc = Alloc())
+        : items_(Allocate(size, alloc)) {
+        ConstructChunks(policy, items_.Get(), size, [&](size_t first, size_t last) {
+            ConstructN(items_.Get() + first, last - first);
+        });
+        size_ = size;
+        capacity_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value, согласно политике policy
+    SimpleVector(ExecutionPolicy policy, size_t size, const Type& value, const Alloc& alloc = Alloc())
+        : items_(Allocate(size, alloc)) {
+        ConstructChunks(policy, items_.Get(), size, [&](size_t first, size_t last) {
+            ConstructN(items_.Get() + first, last - first, value);
+        });
         size_ = size;
         capacity_ = size;
-        items_ = Items(size);
-        std::fill(begin(), end(), value);
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init) {
+    SimpleVector(std::initializer_list<Type> init, const Alloc& alloc = Alloc())
+        : items_(Allocate(init.size(), alloc)) {
+        ConstructFrom(init.begin(), init.end(), items_.Get());
         size_ = init.size();
         capacity_ = init.size();
-        items_ = Items(size_);
-        std::copy(init.begin(), init.end(), begin());
     }
 
     // Создаёт вектор с резервированной вместительностью
-    SimpleVector(ReserveProxyObj capacity) {
+    SimpleVector(ReserveProxyObj capacity, const Alloc& alloc = Alloc())
+        : items_(Allocate(capacity.GetValue(), alloc)) {
         capacity_ = capacity.GetValue();
-        size_ = 0;
+    }
+
+    // Создаёт вектор из диапазона [first, last) не более чем за одно выделение памяти
+    // (для однопроходных итераторов - по мере чтения)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    SimpleVector(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+        : items_(alloc) {
+        try {
+            Append(first, last);
+        } catch(...) {
+            Destroy(begin(), end());
+            throw;
+        }
     }
 
     //Копирующий конструктор
-    SimpleVector(const SimpleVector& other) {
+    //Аллокатор для копии выбирает select_on_container_copy_construction
+    SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    //Копирующий конструктор с явным аллокатором
+    SimpleVector(const SimpleVector& other, const Alloc& alloc)
+        : items_(Allocate(other.size_, alloc)) {
+        ConstructFrom(other.begin(), other.end(), items_.Get());
+        size_ = other.size_;
+        capacity_ = other.size_;
+    }
+
+    //Копирующий конструктор, копирующий элементы согласно политике policy
+    SimpleVector(ExecutionPolicy policy, const SimpleVector& other)
+        : items_(Allocate(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))) {
+        ConstructChunks(policy, items_.Get(), other.size_, [&](size_t first, size_t last) {
+            ConstructFrom(other.begin() + first, other.begin() + last, items_.Get() + first);
+        });
         size_ = other.size_;
-        capacity_ = other.capacity_;
-        items_ = Items(capacity_);
-        std::copy(other.begin(), other.end(), begin());
+        capacity_ = other.size_;
     }
+
     //Копирующее присваивание
+    //Аллокатор rhs перенимается, только если этого требует propagate_on_container_copy_assignment
     SimpleVector& operator=(const SimpleVector& rhs) {
         if(this != &rhs) {
-            SimpleVector temp = SimpleVector(rhs);
-            swap(temp);
+            if constexpr(AllocTraits::propagate_on_container_copy_assignment::value) {
+                SimpleVector temp(rhs, rhs.GetAllocator());
+                items_.swap(temp.items_);
+                SwapSizes(temp);
+            } else {
+                SimpleVector temp(rhs, GetAllocator());
+                swap(temp);
+            }
         }
         return *this;
     }
 
     //Перемещающий конструктор
-    SimpleVector(SimpleVector&& other) {
+    SimpleVector(SimpleVector&& other) noexcept
+        : items_(std::move(other.items_)) {
         size_ = std::exchange(other.size_, 0);
         capacity_ = std::exchange(other.capacity_, 0);
-        items_ = Items(std::move(other.items_));
-        other.items_.Nullify();
     }
+
+    //Перемещающий конструктор с явным аллокатором
+    //Буфер other забирается, только если его можно освободить аллокатором alloc,
+    //иначе элементы поштучно перемещаются в новую память
+    SimpleVector(SimpleVector&& other, const Alloc& alloc)
+        : items_(alloc) {
+        if(AllocTraits::is_always_equal::value || alloc == other.GetAllocator()) {
+            items_.swap(other.items_);
+            SwapSizes(other);
+        } else {
+            Items temp = Allocate(other.size_, alloc);
+            ConstructFrom(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()), temp.Get());
+            items_.swap(temp);
+            size_ = other.size_;
+            capacity_ = other.size_;
+        }
+    }
+
     //Перемещающее присваивание
-    SimpleVector& operator=(SimpleVector&& rhs) {
-        SimpleVector temp = SimpleVector(rhs);
-        swap(temp);
+    //Забирает буфер rhs, не копируя элементы. Если аллокаторы не равны и
+    //propagate_on_container_move_assignment запрещает их передачу, элементы перемещаются поштучно
+    SimpleVector& operator=(SimpleVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                          || AllocTraits::is_always_equal::value) {
+        if(this != &rhs) {
+            if constexpr(AllocTraits::propagate_on_container_move_assignment::value) {
+                SimpleVector temp(std::move(rhs));
+                items_.swap(temp.items_);
+                SwapSizes(temp);
+            } else {
+                SimpleVector temp(std::move(rhs), GetAllocator());
+                swap(temp);
+            }
+        }
         return *this;
     }
 
+    // Разрушает живые элементы, память освобождает items_
     ~SimpleVector() {
-        items_.Release();
+        if(capacity_ != 0) {
+            Stats::OnRelease(capacity_ - size_, sizeof(Type));
+        }
+        Destroy(begin(), end());
+    }
+
+    // Возвращает аллокатор вектора
+    Alloc GetAllocator() const noexcept {
+        return items_.GetAllocator();
     }
 
     // Возвращает количество элементов в массиве
@@ -117,13 +250,13 @@ public:
 
     // Возвращает ссылку на элемент с индексом index
     Type& operator[](size_t index) noexcept {
-        assert(index <= capacity_);
+        assert(index < size_);
         return items_[index];
     }
 
     // Возвращает константную ссылку на элемент с индексом index
     const Type& operator[](size_t index) const noexcept {
-        assert(index <= capacity_);
+        assert(index < size_);
         return items_[index];
     }
 
@@ -147,24 +280,74 @@ public:
         return items_[index];
     }
 
+    // Возвращает итератор на первый элемент, равный value, либо end().
+    // Для арифметических типов поиск векторизован (simd_kernels.h)
+    Iterator Find(const Type& value) {
+        return begin() + simd::Find(items_.Get(), size_, value);
+    }
+
+    ConstIterator Find(const Type& value) const {
+        return begin() + simd::Find(items_.Get(), size_, value);
+    }
+
+    // Возвращает количество элементов, равных value
+    size_t Count(const Type& value) const {
+        return simd::Count(items_.Get(), size_, value);
+    }
+
+    // Возвращает наименьший элемент непустого вектора
+    Type Min() const {
+        assert(size_ != 0);
+        return simd::Min(items_.Get(), size_);
+    }
+
+    // Возвращает наибольший элемент непустого вектора
+    Type Max() const {
+        assert(size_ != 0);
+        return simd::Max(items_.Get(), size_);
+    }
+
+    // Возвращает сумму элементов (Type{} для пустого вектора)
+    Type Sum() const {
+        return simd::Sum(items_.Get(), size_);
+    }
+
     // Обнуляет размер массива, не изменяя его вместимость
     void Clear() noexcept {
+        Destroy(begin(), end());
         size_ = 0;
     }
 
     // Изменяет размер массива.
-    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type,
+    // при уменьшении лишние элементы разрушаются
     void Resize(size_t new_size) {
-        if(new_size <= capacity_) {
-            size_ = new_size;
-        } else {
-            capacity_ = std::max(capacity_*2, new_size);
-            Items temp = Items(capacity_);
-            std::move(begin(), end(), temp.Get());
+        if(new_size <= size_) {
+            Destroy(begin() + new_size, end());
             size_ = new_size;
-            items_.Release();
-            items_ = std::move(temp);
+            return;
+        }
+        if(new_size > capacity_) {
+            Reallocate(NextCapacity(new_size));
+        }
+        ConstructN(end(), new_size - size_);
+        size_ = new_size;
+    }
+
+    // Изменяет размер массива, создавая новые элементы согласно политике policy
+    void Resize(ExecutionPolicy policy, size_t new_size) {
+        if(new_size <= size_) {
+            Resize(new_size);
+            return;
+        }
+        if(new_size > capacity_) {
+            Reallocate(NextCapacity(new_size));
         }
+        Type* dest = end();
+        ConstructChunks(policy, dest, new_size - size_, [&](size_t first, size_t last) {
+            ConstructN(dest + first, last - first);
+        });
+        size_ = new_size;
     }
 
     // Возвращает итератор на начало массива
@@ -207,32 +390,60 @@ public:
     // Добавляет элемент в конец вектора
     // При нехватке места увеличивает вдвое вместимость вектора
     void PushBack(const Type& item) {
-        if(size_ == capacity_) {
-            //С замечанием согласен, обычно придерживаюсь указанного Вами подхода, в этот раз ночные правки сделали своё злое дело
-            Resize(size_ + 1);
-        } else if(size_ == 0) {
-            ++size_;
-            items_ = Items(1);
-        } else {
-            ++size_;
-        }
-
-        items_[size_ - 1] = item;
+        EmplaceBack(item);
     }
 
     // Добавляет элемент в конец вектора, move-версия
     // При нехватке места увеличивает вдвое вместимость вектора
     void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора прямо в его памяти из аргументов args.
+    // Возвращает ссылку на созданный элемент
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
         if(size_ == capacity_) {
-            Resize(size_ + 1);
-        } else if(size_ == 0) {
-            ++size_;
-            items_ = Items(1);
-        } else {
-            ++size_;
+            return *EmplaceWithGrowth(size_, std::forward<Args>(args)...);
         }
+        Construct(end(), std::forward<Args>(args)...);
+        ++size_;
+        return items_[size_ - 1];
+    }
 
-        items_[size_ - 1] = std::move(item);
+    // Создаёт элемент в позиции pos из аргументов args.
+    // Возвращает итератор на созданный элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        if(size_ == capacity_) {
+            return EmplaceWithGrowth(dist, std::forward<Args>(args)...);
+        }
+        if(dist == size_) {
+            Construct(end(), std::forward<Args>(args)...);
+        } else {
+            // args могут ссылаться на элементы вектора, поэтому значение создаётся до сдвига
+            Type value = vector_detail::Make<Type>(std::forward<Args>(args)...);
+            if constexpr(IsTriviallyRelocatableV<Type>) {
+                // Хвост сдвигается одним memmove, освободившаяся ячейка становится сырой памятью.
+                // Если перемещение value бросит исключение, хвост возвращается на место
+                std::memmove(static_cast<void*>(begin() + dist + 1), begin() + dist, (size_ - dist) * sizeof(Type));
+                try {
+                    Construct(begin() + dist, std::move(value));
+                } catch(...) {
+                    std::memmove(static_cast<void*>(begin() + dist), begin() + dist + 1, (size_ - dist) * sizeof(Type));
+                    throw;
+                }
+            } else {
+                // Последний элемент переезжает в сырую ячейку за концом, остальные сдвигаются присваиванием
+                Construct(end(), std::move(items_[size_ - 1]));
+                std::move_backward(begin() + dist, end() - 1, end());
+                items_[dist] = std::move(value);
+            }
+        }
+        ++size_;
+        return begin() + dist;
     }
 
     // Вставляет значение value в позицию pos.
@@ -240,118 +451,868 @@ public:
     // Если перед вставкой значения вектор был заполнен полностью,
     // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
     Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Добавляет в конец вектора элементы [first, last).
+    // Для прямых итераторов память перевыделяется не более одного раза
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        InsertRange(cend(), first, last);
+    }
+
+    // Вставляет элементы [first, last) в позицию pos, сдвигая хвост один раз.
+    // Для прямых итераторов память перевыделяется не более одного раза,
+    // однопроходные дописываются в конец и переставляются на место поворотом.
+    // Диапазон не должен указывать на элементы самого вектора.
+    // Возвращает итератор на первый вставленный элемент
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    Iterator InsertRange(ConstIterator pos, InputIt first, InputIt last) {
         assert(pos >= begin() && pos <= end());
-        auto dist = std::distance(begin(), const_cast<Iterator>(pos));
-        if(capacity_ == 0) {
-            Resize(1);
-            items_[0] = value;
-            return begin();
-        } else if(size_ == capacity_) {
-            Resize(size_ + 1);
+        const size_t dist = pos - cbegin();
+        if constexpr(IsForwardIteratorV<InputIt>) {
+            const size_t count = std::distance(first, last);
+            if(count == 0) {
+                return begin() + dist;
+            }
+            if(size_ + count > capacity_) {
+                return GrowAround(dist, count, [&](Type* hole) {
+                    ConstructFrom(first, last, hole);
+                });
+            }
+            InsertInPlace(dist, first, last, count);
         } else {
-            ++size_;
+            const size_t old_size = size_;
+            for(; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(begin() + dist, begin() + old_size, end());
         }
-        std::copy_backward(begin() + dist, end() - 1, end());
-        //Намного резоннее использовать items_, действительно
-        items_[dist] = move(value);
         return begin() + dist;
     }
 
-    Iterator Insert(Iterator pos, Type&& value) {
-        assert(pos >= begin() && pos <= end());
-        auto dist = std::distance(std::make_move_iterator(begin()), std::make_move_iterator(pos));
-        if(capacity_ == 0) {
-            Resize(1);
-            items_[0] = std::move(value);
-            return begin();
-        } else if(size_ == capacity_) {
-            Resize(size_ + 1);
+    // Заменяет содержимое вектора элементами [first, last).
+    // Если они помещаются в текущую вместимость, память не перевыделяется
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    void AssignRange(InputIt first, InputIt last) {
+        if constexpr(IsForwardIteratorV<InputIt>) {
+            const size_t count = std::distance(first, last);
+            if(count > capacity_) {
+                Items temp = Allocate(count, items_.GetAllocator());
+                ConstructFrom(first, last, temp.Get());
+                Destroy(begin(), end());
+                items_.swap(temp);
+                size_ = count;
+                capacity_ = count;
+                return;
+            }
+            if(count <= size_) {
+                Iterator new_end = std::copy(first, last, begin());
+                Destroy(new_end, end());
+                size_ = count;
+            } else {
+                InputIt mid = std::next(first, size_);
+                std::copy(first, mid, begin());
+                ConstructFrom(mid, last, end());
+                size_ = count;
+            }
         } else {
-            ++size_;
+            Clear();
+            Append(first, last);
         }
-        std::move_backward(begin() + dist, end() - 1,
-                           end());
-        items_[dist] = std::move(value);
-        return begin() + dist;
     }
 
-    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
     void PopBack() noexcept {
         //В задании указывалось что сюда не будут передавать инвалидные значения, поэтому проверку не делал изначально
         assert(size_ != 0);
         --size_;
+        AllocTraits::destroy(items_.GetAllocator(), end());
     }
 
     // Удаляет элемент вектора в указанной позиции
     Iterator Erase(ConstIterator pos) {
         assert(!IsEmpty());
-        assert(pos >= begin() && pos <= end());
-        Iterator res = const_cast<Iterator>(pos);
-        std::copy(res + 1, end(), res);
-        --size_;
+        assert(pos >= begin() && pos < end());
+        Iterator res = begin() + (pos - cbegin());
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            AllocTraits::destroy(items_.GetAllocator(), res);
+            std::memmove(static_cast<void*>(res), res + 1, (end() - res - 1) * sizeof(Type));
+            --size_;
+        } else {
+            std::move(res + 1, end(), res);
+            PopBack();
+        }
         return res;
     }
 
-    Iterator Erase(Iterator pos) {
-        assert(!IsEmpty());
-        assert(pos >= begin() && pos <= end());
-        std::copy(std::make_move_iterator(pos + 1), std::make_move_iterator(end()), pos);
-        --size_;
-        return pos;
+    // Удаляет элементы [first, last), сдвигая хвост один раз.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator EraseRange(ConstIterator first, ConstIterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        Iterator res = begin() + (first - cbegin());
+        const size_t count = last - first;
+        if(count == 0) {
+            return res;
+        }
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            Destroy(res, res + count);
+            std::memmove(static_cast<void*>(res), res + count, (end() - res - count) * sizeof(Type));
+        } else {
+            Iterator new_end = std::move(res + count, end(), res);
+            Destroy(new_end, end());
+        }
+        size_ -= count;
+        return res;
+    }
+
+    // Удаляет все элементы, для которых pred истинен, за один проход с сохранением порядка
+    // (вместо O(n^2) для Erase в цикле). Возвращает количество удалённых
+    template <typename Pred>
+    size_t EraseIf(Pred pred) {
+        const size_t kept = simd::RemoveIf(items_.Get(), size_, pred);
+        Destroy(begin() + kept, end());
+        const size_t removed = size_ - kept;
+        size_ = kept;
+        return removed;
+    }
+
+    // Удаляет элемент в позиции pos за O(1), перенося на его место последний.
+    // Порядок элементов не сохраняется. Возвращает итератор на элемент, занявший место удалённого
+    Iterator SwapRemove(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        Iterator res = begin() + (pos - cbegin());
+        Iterator last = end() - 1;
+        if(res != last) {
+            *res = std::move(*last);
+        }
+        PopBack();
+        return res;
+    }
+
+    // Удаляет все элементы, для которых pred истинен, заполняя дыры элементами с конца:
+    // O(1) на удалённый элемент, порядок не сохраняется. Возвращает количество удалённых
+    template <typename Pred>
+    size_t UnorderedEraseIf(Pred pred) {
+        Iterator first = begin();
+        Iterator last = end();
+        while(first != last) {
+            if(pred(*first)) {
+                --last;
+                if(first != last) {
+                    *first = std::move(*last);
+                }
+            } else {
+                ++first;
+            }
+        }
+        const size_t removed = end() - last;
+        Destroy(last, end());
+        size_ -= removed;
+        return removed;
     }
 
     // Обменивает значение с другим вектором
+    // Если propagate_on_container_swap не задан, аллокаторы векторов должны быть равны
     void swap(SimpleVector& other) noexcept {
-        std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
+        if constexpr(!AllocTraits::propagate_on_container_swap::value) {
+            assert(GetAllocator() == other.GetAllocator());
+        }
         items_.swap(other.items_);
+        SwapSizes(other);
     }
 
     void Reserve(size_t new_capacity) {
         if(new_capacity > capacity_) {
-            Items temp = Items(capacity_);
-            std::copy(begin(), end(), temp.Get());
-            items_.Release();
-            items_ = temp;
-            capacity_ = new_capacity;
+            Reallocate(new_capacity);
+        }
+    }
+
+    // Дописывает в конец до count тривиально копируемых элементов: fill(dest, count)
+    // записывает их байты прямо в сырую память после последнего элемента и возвращает,
+    // сколько элементов записал. Память под count элементов резервируется заранее.
+    // Если fill выбрасывает исключение, размер не меняется
+    template <typename Fill>
+    size_t AppendUninitialized(size_t count, Fill fill) {
+        static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable elements can be filled as raw bytes");
+        if(count > capacity_ - size_) {
+            Reallocate(NextCapacity(size_ + count));
+        }
+        const size_t written = fill(end(), count);
+        assert(written <= count);
+        size_ += written;
+        return written;
+    }
+
+    // Уменьшает вместимость до размера, освобождая лишнюю память
+    void ShrinkToFit() {
+        if(capacity_ == size_) {
+            return;
+        }
+        Stats::OnRelease(capacity_ - size_, sizeof(Type));
+        if(size_ == 0) {
+            Items(items_.GetAllocator()).swap(items_);
+            capacity_ = 0;
+        } else {
+            Reallocate(size_);
         }
     }
 
 private:
-    ArrayPtr<Type> items_;
-    size_t size_;
-    size_t capacity_;
+    // std::allocator создаёт элементы обычным размещающим new,
+    // поэтому для него подходят стандартные алгоритмы над сырой памятью
+    static constexpr bool kPlainConstruct = std::is_same_v<Alloc, std::allocator<Type>>;
+
+    // Выделяет буфер на capacity элементов и учитывает выделение в статистике
+    static Items Allocate(size_t capacity, const Alloc& alloc) {
+        if(capacity != 0) {
+            Stats::OnAllocate(capacity);
+        }
+        return Items(capacity, alloc);
+    }
+
+    // Вместимость после роста, достаточная для required элементов
+    size_t NextCapacity(size_t required) const noexcept {
+        return std::max(Growth::NextCapacity(capacity_, required, sizeof(Type)), required);
+    }
+
+    // Переносит [first, last) в сырую память dest. Тривиально переносимые типы копируются
+    // одним memcpy. Остальные, как и в std::vector, перемещаются, только если перемещение
+    // не бросает исключений (или копирование невозможно), иначе копируются:
+    // при исключении старый буфер остаётся нетронутым
+    void RelocateRange(Iterator first, Iterator last, Type* dest) {
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            if(first != last) {
+                std::memcpy(static_cast<void*>(dest), first, (last - first) * sizeof(Type));
+            }
+        } else if constexpr(std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            ConstructFrom(std::make_move_iterator(first), std::make_move_iterator(last), dest);
+        } else {
+            ConstructFrom(first, last, dest);
+        }
+    }
+
+    // Завершает жизнь исходных элементов после RelocateRange.
+    // Тривиально перенесённые элементы уже живут в новом буфере и не разрушаются
+    void DestroyRelocated(Iterator first, Iterator last) noexcept {
+        if constexpr(!IsTriviallyRelocatableV<Type>) {
+            Destroy(first, last);
+        }
+    }
+
+    // Переносит элементы в новый буфер вместимостью new_capacity.
+    // Создаются только перенесённые элементы, остаток буфера остаётся сырой памятью
+    void Reallocate(size_t new_capacity) {
+        Items temp = Allocate(new_capacity, items_.GetAllocator());
+        const auto timer = Stats::StartGrowth();
+        RelocateRange(begin(), end(), temp.Get());
+        DestroyRelocated(begin(), end());
+        if(capacity_ != 0) {
+            Stats::OnRelocate(timer, size_, sizeof(Type));
+        }
+        items_.swap(temp);
+        capacity_ = new_capacity;
+    }
+
+    // Создаёт элемент в ячейке raw через аллокатор.
+    // Агрегаты без подходящего конструктора создаются через {}
+    template <typename... Args>
+    void Construct(Type* raw, Args&&... args) {
+        if constexpr(std::is_constructible_v<Type, Args...>) {
+            AllocTraits::construct(items_.GetAllocator(), raw, std::forward<Args>(args)...);
+        } else {
+            new (raw) Type{std::forward<Args>(args)...};
+        }
+    }
+
+    // Создаёт в сырой памяти dest копии [first, last) (или перемещённые значения для move_iterator).
+    // При исключении уже созданные элементы разрушаются
+    template <typename InputIt>
+    void ConstructFrom(InputIt first, InputIt last, Type* dest) {
+        if constexpr(kPlainConstruct) {
+            std::uninitialized_copy(first, last, dest);
+        } else {
+            Type* current = dest;
+            try {
+                for(; first != last; ++first, ++current) {
+                    Construct(current, *first);
+                }
+            } catch(...) {
+                Destroy(dest, current);
+                throw;
+            }
+        }
+    }
+
+    // Создаёт в сырой памяти dest count элементов из args (без args - значения по умолчанию).
+    // При исключении уже созданные элементы разрушаются
+    template <typename... Args>
+    void ConstructN(Type* dest, size_t count, const Args&... args) {
+        if constexpr(kPlainConstruct && sizeof...(Args) == 0) {
+            std::uninitialized_value_construct_n(dest, count);
+        } else if constexpr(kPlainConstruct) {
+            std::uninitialized_fill_n(dest, count, args...);
+        } else {
+            size_t done = 0;
+            try {
+                for(; done < count; ++done) {
+                    Construct(dest + done, args...);
+                }
+            } catch(...) {
+                Destroy(dest, dest + done);
+                throw;
+            }
+        }
+    }
+
+    // Создаёт count элементов в сырой памяти dest: construct(first, last) создаёт [first, last)
+    // и при исключении разрушает то, что успел создать. Куски создаются на пуле потоков
+    // только для std::allocator: construct других аллокаторов может обращаться к общему
+    // ресурсу памяти, не рассчитанному на несколько потоков
+    template <typename ConstructRange>
+    void ConstructChunks(ExecutionPolicy policy, Type* dest, size_t count, ConstructRange construct) {
+        if constexpr(!kPlainConstruct) {
+            policy = Sequential();
+        }
+        const ChunkPlan<Type> plan(dest, count, policy);
+        if(plan.GetCount() == 1) {
+            construct(size_t{0}, count);
+            return;
+        }
+        std::unique_ptr<bool[]> constructed(new bool[plan.GetCount()]());
+        try {
+            policy.ParallelFor(plan.GetCount(), [&](size_t chunk) {
+                construct(plan.Begin(chunk), plan.End(chunk));
+                constructed[chunk] = true;
+            });
+        } catch(...) {
+            for(size_t chunk = 0; chunk < plan.GetCount(); ++chunk) {
+                if(constructed[chunk]) {
+                    Destroy(dest + plan.Begin(chunk), dest + plan.End(chunk));
+                }
+            }
+            throw;
+        }
+    }
+
+    // Разрушает элементы [first, last) через аллокатор
+    void Destroy(Iterator first, Iterator last) noexcept {
+        if constexpr(kPlainConstruct) {
+            std::destroy(first, last);
+        } else {
+            for(; first != last; ++first) {
+                AllocTraits::destroy(items_.GetAllocator(), first);
+            }
+        }
+    }
+
+    void SwapSizes(SimpleVector& other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Вставка в заполненный вектор: новый элемент создаётся в новом буфере раньше,
+    // чем переносятся старые, поэтому args могут ссылаться на элементы самого вектора
+    template <typename... Args>
+    Iterator EmplaceWithGrowth(size_t dist, Args&&... args) {
+        return GrowAround(dist, 1, [&](Type* hole) {
+            Construct(hole, std::forward<Args>(args)...);
+        });
+    }
+
+    // Переезжает в новый буфер, оставляя в позиции dist дыру из count ячеек.
+    // fill(hole) создаёт в дыре новые элементы до переноса старых
+    template <typename Fill>
+    Iterator GrowAround(size_t dist, size_t count, Fill fill) {
+        const size_t new_capacity = NextCapacity(size_ + count);
+        Items temp = Allocate(new_capacity, items_.GetAllocator());
+        const auto timer = Stats::StartGrowth();
+        Type* hole = temp.Get() + dist;
+        fill(hole);
+        try {
+            RelocateRange(begin(), begin() + dist, temp.Get());
+            try {
+                RelocateRange(begin() + dist, end(), hole + count);
+            } catch(...) {
+                Destroy(temp.Get(), hole);
+                throw;
+            }
+        } catch(...) {
+            Destroy(hole, hole + count);
+            throw;
+        }
+        DestroyRelocated(begin(), end());
+        if(capacity_ != 0) {
+            Stats::OnRelocate(timer, size_, sizeof(Type));
+        }
+        items_.swap(temp);
+        capacity_ = new_capacity;
+        size_ += count;
+        return begin() + dist;
+    }
+
+    // Вставка count элементов [first, last) в позицию dist без перевыделения
+    template <typename ForwardIt>
+    void InsertInPlace(size_t dist, ForwardIt first, ForwardIt last, size_t count) {
+        Iterator pos = begin() + dist;
+        Iterator old_end = end();
+        const size_t tail = size_ - dist;
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            std::memmove(static_cast<void*>(pos + count), pos, tail * sizeof(Type));
+            try {
+                ConstructFrom(first, last, pos);
+            } catch(...) {
+                std::memmove(static_cast<void*>(pos), pos + count, tail * sizeof(Type));
+                throw;
+            }
+            size_ += count;
+        } else if(tail > count) {
+            // Последние count элементов переезжают в сырую память, остальные сдвигаются присваиванием
+            ConstructFrom(std::make_move_iterator(old_end - count), std::make_move_iterator(old_end), old_end);
+            size_ += count;
+            std::move_backward(pos, old_end - count, old_end);
+            std::copy(first, last, pos);
+        } else {
+            // Вставка длиннее хвоста: часть диапазона и весь хвост создаются в сырой памяти
+            ForwardIt mid = std::next(first, tail);
+            ConstructFrom(mid, last, old_end);
+            size_ += count - tail;
+            ConstructFrom(std::make_move_iterator(pos), std::make_move_iterator(old_end), end());
+            size_ += tail;
+            std::copy(first, mid, pos);
+        }
+    }
+
+private:
+    Items items_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
 };
 
-template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    if(lhs.GetSize() != rhs.GetSize()) {
-        return false;
+// Сравнения выполняются за один проход ядрами simd::Equal и simd::Compare,
+// для арифметических типов - векторно
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator==(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator!=(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator<(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return simd::Compare(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize()) < 0;
+}
+
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator<=(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return simd::Compare(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize()) <= 0;
+}
+
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator>(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Alloc, typename Growth>
+inline bool operator>=(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    return simd::Compare(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize()) >= 0;
+}
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+// Трёхстороннее сравнение C++20. Целые сравниваются векторным ядром,
+// остальные типы - через их собственный operator<=>
+template <typename Type, typename Alloc, typename Growth>
+    requires std::three_way_comparable<Type>
+inline auto operator<=>(const SimpleVector<Type, Alloc, Growth>& lhs, const SimpleVector<Type, Alloc, Growth>& rhs) {
+    if constexpr(simd::kVectorizableOrdered<Type>) {
+        return simd::Compare(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize()) <=> 0;
+    } else {
+        return std::lexicographical_compare_three_way(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
     }
-    return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
+#endif
 
-template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+// Вектор с встроенным буфером на N элементов: пока элементов не больше N, они хранятся
+// прямо в объекте без обращения к куче, при переполнении переезжают в ArrayPtr.
+// Интерфейс совпадает с SimpleVector
+template <typename Type, size_t N>
+class SmallSimpleVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using Items = ArrayPtr<Type>;
+
+    SmallSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallSimpleVector(size_t size) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(begin(), size);
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallSimpleVector(size_t size, const Type& value) {
+        Reserve(size);
+        std::uninitialized_fill_n(begin(), size, value);
+        size_ = size;
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallSimpleVector(std::initializer_list<Type> init) {
+        Reserve(init.size());
+        std::uninitialized_copy(init.begin(), init.end(), begin());
+        size_ = init.size();
+    }
+
+    //Копирующий конструктор
+    SmallSimpleVector(const SmallSimpleVector& other) {
+        Reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), begin());
+        size_ = other.size_;
+    }
+    //Копирующее присваивание
+    SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+        if(this != &rhs) {
+            SmallSimpleVector temp(rhs);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    //Перемещающий конструктор
+    //Куча забирается целиком, встроенные элементы перемещаются поштучно
+    SmallSimpleVector(SmallSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        TakeFrom(other);
+    }
+    //Перемещающее присваивание
+    SmallSimpleVector& operator=(SmallSimpleVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if(this != &rhs) {
+            Clear();
+            heap_ = Items();
+            capacity_ = N;
+            TakeFrom(rhs);
+        }
+        return *this;
+    }
+
+    ~SmallSimpleVector() {
+        std::destroy(begin(), end());
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива, не меньше N
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, хранятся ли элементы во встроенном буфере
+    bool IsInline() const noexcept {
+        return !heap_;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return begin()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return begin()[index];
+    }
+
+    // Разрушает все элементы, не изменяя вместимость
+    void Clear() noexcept {
+        std::destroy(begin(), end());
+        size_ = 0;
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type,
+    // при уменьшении лишние элементы разрушаются
+    void Resize(size_t new_size) {
+        if(new_size <= size_) {
+            std::destroy(begin() + new_size, end());
+            size_ = new_size;
+            return;
+        }
+        if(new_size > capacity_) {
+            Reallocate(std::max(capacity_ * 2, new_size));
+        }
+        std::uninitialized_value_construct(end(), begin() + new_size);
+        size_ = new_size;
+    }
+
+    Iterator begin() noexcept {
+        return IsInline() ? InlineData() : heap_.Get();
+    }
+
+    Iterator end() noexcept {
+        return begin() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return IsInline() ? InlineData() : heap_.Get();
+    }
+
+    ConstIterator end() const noexcept {
+        return begin() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Добавляет элемент в конец вектора
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    // Добавляет элемент в конец вектора, move-версия
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args. Возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if(size_ == capacity_) {
+            return *EmplaceWithGrowth(size_, std::forward<Args>(args)...);
+        }
+        Construct(end(), std::forward<Args>(args)...);
+        ++size_;
+        return *(end() - 1);
+    }
+
+    // Создаёт элемент в позиции pos из аргументов args. Возвращает итератор на него
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        if(size_ == capacity_) {
+            return EmplaceWithGrowth(dist, std::forward<Args>(args)...);
+        }
+        if(dist == size_) {
+            Construct(end(), std::forward<Args>(args)...);
+        } else {
+            // args могут ссылаться на элементы вектора, поэтому значение создаётся до сдвига
+            Type value = vector_detail::Make<Type>(std::forward<Args>(args)...);
+            new (end()) Type(std::move(*(end() - 1)));
+            std::move_backward(begin() + dist, end() - 1, end());
+            begin()[dist] = std::move(value);
+        }
+        ++size_;
+        return begin() + dist;
+    }
+
+    // Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        std::destroy_at(end());
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        Iterator res = begin() + (pos - cbegin());
+        std::move(res + 1, end(), res);
+        PopBack();
+        return res;
+    }
+
+    // Обменивает значение с другим вектором
+    void swap(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        SmallSimpleVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    // Гарантирует вместимость не меньше new_capacity, при необходимости переезжая в кучу
+    void Reserve(size_t new_capacity) {
+        if(new_capacity > capacity_) {
+            Reallocate(new_capacity);
+        }
+    }
+
+private:
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_);
+    }
+
+    const Type* InlineData() const noexcept {
+        return reinterpret_cast<const Type*>(inline_);
+    }
+
+    template <typename... Args>
+    static void Construct(Type* raw, Args&&... args) {
+        if constexpr(std::is_constructible_v<Type, Args...>) {
+            new (raw) Type(std::forward<Args>(args)...);
+        } else {
+            new (raw) Type{std::forward<Args>(args)...};
+        }
+    }
+
+    // Переносит [first, last) в сырую память dest по тем же правилам, что и SimpleVector
+    static void RelocateRange(Iterator first, Iterator last, Type* dest) {
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            if(first != last) {
+                std::memcpy(static_cast<void*>(dest), first, (last - first) * sizeof(Type));
+            }
+        } else if constexpr(std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            std::uninitialized_move(first, last, dest);
+        } else {
+            std::uninitialized_copy(first, last, dest);
+        }
+    }
+
+    static void DestroyRelocated(Iterator first, Iterator last) noexcept {
+        if constexpr(!IsTriviallyRelocatableV<Type>) {
+            std::destroy(first, last);
+        }
+    }
+
+    void Reallocate(size_t new_capacity) {
+        Items temp(new_capacity);
+        RelocateRange(begin(), end(), temp.Get());
+        DestroyRelocated(begin(), end());
+        heap_.swap(temp);
+        capacity_ = new_capacity;
+    }
+
+    template <typename... Args>
+    Iterator EmplaceWithGrowth(size_t dist, Args&&... args) {
+        const size_t new_capacity = capacity_ * 2;
+        Items temp(new_capacity);
+        Type* slot = temp.Get() + dist;
+        Construct(slot, std::forward<Args>(args)...);
+        try {
+            RelocateRange(begin(), begin() + dist, temp.Get());
+            try {
+                RelocateRange(begin() + dist, end(), slot + 1);
+            } catch(...) {
+                std::destroy(temp.Get(), slot);
+                throw;
+            }
+        } catch(...) {
+            std::destroy_at(slot);
+            throw;
+        }
+        DestroyRelocated(begin(), end());
+        heap_.swap(temp);
+        capacity_ = new_capacity;
+        ++size_;
+        return begin() + dist;
+    }
+
+    // Забирает содержимое other, сам вектор должен быть пустым и встроенным
+    void TakeFrom(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if(other.IsInline()) {
+            std::uninitialized_move(other.begin(), other.end(), InlineData());
+            size_ = other.size_;
+            capacity_ = N;
+            other.Clear();
+        } else {
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, N);
+        }
+    }
+
+    Items heap_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(Type) unsigned char inline_[N * sizeof(Type)];
+};
+
+template <typename Type, size_t N>
+inline bool operator==(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+    return simd::Equal(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N>
+inline bool operator!=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+template <typename Type, size_t N>
+inline bool operator<(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+    return simd::Compare(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize()) < 0;
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs == rhs) || (lhs < rhs);
+template <typename Type, size_t N>
+inline bool operator<=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+    return !(rhs < lhs);
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, size_t N>
+inline bool operator>(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
     return rhs < lhs;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs == rhs) || (lhs > rhs);
-}
\ No newline at end of file
+template <typename Type, size_t N>
+inline bool operator>=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+    return !(lhs < rhs);
+}
+
+namespace pmr {
+
+// Вектор, память которого берётся из std::pmr::memory_resource,
+// например из std::pmr::monotonic_buffer_resource, освобождаемого целиком
+template <typename Type, typename Growth = DoublingGrowth>
+using SimpleVector = ::SimpleVector<Type, std::pmr::polymorphic_allocator<Type>, Growth>;
+
+} // namespace pmr
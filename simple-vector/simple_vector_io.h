@@ -0,0 +1,247 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичная сериализация SimpleVector из тривиально копируемых элементов.
+// Формат: 16-байтный заголовок (сигнатура, размер элемента, количество элементов)
+// и сразу за ним байты буфера. Порядок байт - родной для машины.
+// Запись - один вызов write/writev на весь буфер, чтение - прямо в зарезервированную
+// неинициализированную память без разбора по элементам.
+// Ошибки потоков выбрасываются как std::ios_base::failure, ошибки системных
+// вызовов - как std::system_error, несовпадение формата - как std::runtime_error.
+
+namespace simple_vector_io {
+
+struct Header {
+    char magic[4];
+    uint32_t element_size;
+    uint64_t count;
+};
+
+inline constexpr char kMagic[4] = {'S', 'V', 'E', 'C'};
+
+template <typename Type>
+Header MakeHeader(size_t count) noexcept {
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.element_size = sizeof(Type);
+    header.count = count;
+    return header;
+}
+
+template <typename Type>
+size_t CheckHeader(const Header& header) {
+    if(std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Input is not a serialized SimpleVector");
+    }
+    if(header.element_size != sizeof(Type)) {
+        throw std::runtime_error("Serialized SimpleVector has elements of a different size");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+// Читает из потока до bytes байт в dest, возвращает прочитанное количество
+inline size_t ReadSome(std::istream& in, void* dest, size_t bytes) {
+    in.read(static_cast<char*>(dest), static_cast<std::streamsize>(bytes));
+    if(in.bad()) {
+        throw std::ios_base::failure("Failed to read SimpleVector");
+    }
+    return static_cast<size_t>(in.gcount());
+}
+
+// Читает из дескриптора до bytes байт в dest, возвращает прочитанное количество (меньше - только на конце файла)
+inline size_t ReadSome(int fd, void* dest, size_t bytes) {
+    size_t done = 0;
+    while(done < bytes) {
+        const ssize_t result = ::read(fd, static_cast<char*>(dest) + done, bytes - done);
+        if(result < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if(result == 0) {
+            break;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return done;
+}
+
+template <typename Source>
+void ReadExactly(Source& source, void* dest, size_t bytes) {
+    if(ReadSome(source, dest, bytes) != bytes) {
+        throw std::runtime_error("Serialized SimpleVector is truncated");
+    }
+}
+
+// Пишет все iovcnt буферов, повторяя writev после частичной записи
+inline void WriteAll(int fd, iovec* iov, int iovcnt) {
+    while(iovcnt > 0) {
+        const ssize_t result = ::writev(fd, iov, iovcnt);
+        if(result < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        size_t written = static_cast<size_t>(result);
+        while(iovcnt > 0 && written >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if(iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+// Сколько целых элементов Type осталось до конца source. Известно только для обычных
+// файлов по дескриптору; для потоков и каналов ограничения нет
+template <typename Type>
+size_t RemainingElements(std::istream&) noexcept {
+    return SIZE_MAX;
+}
+
+template <typename Type>
+size_t RemainingElements(int fd) noexcept {
+    struct stat info;
+    if(::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return SIZE_MAX;
+    }
+    const off_t position = ::lseek(fd, 0, SEEK_CUR);
+    if(position < 0 || position > info.st_size) {
+        return SIZE_MAX;
+    }
+    return static_cast<size_t>(info.st_size - position) / sizeof(Type);
+}
+
+// Наибольший пакет при чтении по недоверенному количеству из заголовка
+template <typename Type>
+inline constexpr size_t kDeserializeBatch = (size_t(1) << 20) / sizeof(Type) != 0 ? (size_t(1) << 20) / sizeof(Type) : 1;
+
+// Дописывает в vector до count элементов из source, читая байты прямо в его память.
+// Возвращает количество прочитанных целых элементов
+template <typename Type, typename Alloc, typename Growth, typename Source>
+size_t AppendBatch(SimpleVector<Type, Alloc, Growth>& vector, Source& source, size_t count) {
+    return vector.AppendUninitialized(count, [&](Type* dest, size_t capacity) {
+        const size_t bytes = ReadSome(source, dest, capacity * sizeof(Type));
+        if(bytes % sizeof(Type) != 0) {
+            throw std::runtime_error("Input ends in the middle of an element");
+        }
+        return bytes / sizeof(Type);
+    });
+}
+
+// Пустой пакет никогда не достигает конца ввода, и потоковое чтение не завершилось бы
+inline void CheckBatchSize(size_t batch_size) {
+    if(batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+}
+
+} // namespace simple_vector_io
+
+// Записывает vector в поток одним write для буфера
+template <typename Type, typename Alloc, typename Growth>
+void Serialize(const SimpleVector<Type, Alloc, Growth>& vector, std::ostream& out) {
+    static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable elements can be serialized");
+    const simple_vector_io::Header header = simple_vector_io::MakeHeader<Type>(vector.GetSize());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(vector.cbegin()), static_cast<std::streamsize>(vector.GetSize() * sizeof(Type)));
+    if(!out) {
+        throw std::ios_base::failure("Failed to write SimpleVector");
+    }
+}
+
+// Записывает vector в файловый дескриптор одним writev для заголовка и буфера
+template <typename Type, typename Alloc, typename Growth>
+void Serialize(const SimpleVector<Type, Alloc, Growth>& vector, int fd) {
+    static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable elements can be serialized");
+    simple_vector_io::Header header = simple_vector_io::MakeHeader<Type>(vector.GetSize());
+    iovec iov[2] = {
+        {&header, sizeof(header)},
+        {const_cast<Type*>(vector.cbegin()), vector.GetSize() * sizeof(Type)},
+    };
+    simple_vector_io::WriteAll(fd, iov, vector.GetSize() != 0 ? 2 : 1);
+}
+
+// Читает вектор, записанный Serialize, из потока или файлового дескриптора.
+// Байты читаются прямо в память вектора. Количество из заголовка не доверяется:
+// для файла оно сверяется с остатком файла и память резервируется один раз,
+// для потока чтение идёт пакетами, и память растёт только под действительно прочитанные данные
+template <typename Type, typename Alloc = std::allocator<Type>, typename Growth = DoublingGrowth, typename Source>
+SimpleVector<Type, Alloc, Growth> Deserialize(Source&& source, const Alloc& alloc = Alloc()) {
+    static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable elements can be deserialized");
+    simple_vector_io::Header header;
+    simple_vector_io::ReadExactly(source, &header, sizeof(header));
+    const size_t count = simple_vector_io::CheckHeader<Type>(header);
+    const size_t remaining = simple_vector_io::RemainingElements<Type>(source);
+    if(count > remaining) {
+        throw std::runtime_error("Serialized SimpleVector is truncated");
+    }
+    SimpleVector<Type, Alloc, Growth> result(alloc);
+    if(remaining != SIZE_MAX) {
+        result.Reserve(count);
+    }
+    for(size_t left = count; left != 0;) {
+        const size_t batch = std::min(left, simple_vector_io::kDeserializeBatch<Type>);
+        if(simple_vector_io::AppendBatch(result, source, batch) != batch) {
+            throw std::runtime_error("Serialized SimpleVector is truncated");
+        }
+        left -= batch;
+    }
+    return result;
+}
+
+// Потоковый режим: дописывает в vector сырые элементы (без заголовка) из потока или
+// дескриптора до конца ввода, читая пакетами по batch_size элементов прямо в память вектора.
+// Возвращает количество добавленных элементов. При batch_size == 0 бросает std::invalid_argument
+template <typename Type, typename Alloc, typename Growth, typename Source>
+size_t AppendFrom(SimpleVector<Type, Alloc, Growth>& vector, Source&& source, size_t batch_size = 64 * 1024) {
+    simple_vector_io::CheckBatchSize(batch_size);
+    size_t total = 0;
+    while(true) {
+        const size_t read = simple_vector_io::AppendBatch(vector, source, batch_size);
+        total += read;
+        if(read < batch_size) {
+            return total;
+        }
+    }
+}
+
+// Потоковый режим без накопления: читает сырые элементы пакетами по batch_size
+// в один переиспользуемый буфер и передаёт каждый пакет в on_batch(const SimpleVector<Type>&).
+// В памяти одновременно находится не больше одного пакета. При batch_size == 0 бросает std::invalid_argument
+template <typename Type, typename Source, typename OnBatch>
+void ForEachBatch(Source&& source, size_t batch_size, OnBatch on_batch) {
+    simple_vector_io::CheckBatchSize(batch_size);
+    SimpleVector<Type> batch(Reserve(batch_size));
+    while(true) {
+        batch.Clear();
+        const size_t read = simple_vector_io::AppendBatch(batch, source, batch_size);
+        if(read != 0) {
+            on_batch(static_cast<const SimpleVector<Type>&>(batch));
+        }
+        if(read < batch_size) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef SIMPLE_VECTOR_ENABLE_STATS
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <typeinfo>
+#endif
+
+// Счётчики выделений и роста SimpleVector.
+// Собираются, только если до подключения simple_vector.h определён SIMPLE_VECTOR_ENABLE_STATS,
+// иначе все хуки пустые и компилятор их полностью убирает.
+// Счётчики ведутся для каждой инстанциации SimpleVector и для каждого места вызова,
+// отмеченного SIMPLE_VECTOR_STATS_SCOPE("имя"): рост векторов внутри области видимости
+// этого макроса (в том же потоке) засчитывается ему.
+
+// Снимок счётчиков
+struct SimpleVectorStats {
+    uint64_t allocations = 0;           // выделения буферов
+    uint64_t reallocations = 0;         // переезды элементов в новый буфер при росте
+    uint64_t elements_relocated = 0;    // элементы, перенесённые при переездах
+    uint64_t bytes_relocated = 0;       // их суммарный размер
+    uint64_t peak_capacity = 0;         // наибольшая вместимость одного вектора
+    uint64_t unused_bytes_released = 0; // неиспользованная вместимость освобождённых буферов
+    uint64_t growth_ns = 0;             // время, проведённое в переездах
+};
+
+#ifdef SIMPLE_VECTOR_ENABLE_STATS
+
+namespace simple_vector_stats {
+
+class Counters {
+public:
+    void OnAllocate(uint64_t capacity) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while(capacity > peak && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    void OnRelocate(uint64_t elements, uint64_t bytes, uint64_t ns) noexcept {
+        reallocations_.fetch_add(1, std::memory_order_relaxed);
+        elements_relocated_.fetch_add(elements, std::memory_order_relaxed);
+        bytes_relocated_.fetch_add(bytes, std::memory_order_relaxed);
+        growth_ns_.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    void OnRelease(uint64_t unused_bytes) noexcept {
+        unused_bytes_released_.fetch_add(unused_bytes, std::memory_order_relaxed);
+    }
+
+    SimpleVectorStats Snapshot() const noexcept {
+        SimpleVectorStats stats;
+        stats.allocations = allocations_.load(std::memory_order_relaxed);
+        stats.reallocations = reallocations_.load(std::memory_order_relaxed);
+        stats.elements_relocated = elements_relocated_.load(std::memory_order_relaxed);
+        stats.bytes_relocated = bytes_relocated_.load(std::memory_order_relaxed);
+        stats.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        stats.unused_bytes_released = unused_bytes_released_.load(std::memory_order_relaxed);
+        stats.growth_ns = growth_ns_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> reallocations_{0};
+    std::atomic<uint64_t> elements_relocated_{0};
+    std::atomic<uint64_t> bytes_relocated_{0};
+    std::atomic<uint64_t> peak_capacity_{0};
+    std::atomic<uint64_t> unused_bytes_released_{0};
+    std::atomic<uint64_t> growth_ns_{0};
+};
+
+// Реестр именованных счётчиков: инстанциаций (по имени типа) и мест вызова.
+// Счётчики никогда не удаляются, поэтому ссылки на них можно кешировать
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    Counters& Get(std::string name, bool is_site) {
+        std::lock_guard guard(mutex_);
+        auto& entries = is_site ? sites_ : types_;
+        for(auto& [entry_name, counters] : entries) {
+            if(entry_name == name) {
+                return counters;
+            }
+        }
+        return entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::move(name)),
+                                    std::forward_as_tuple()).second;
+    }
+
+    std::vector<std::pair<std::string, SimpleVectorStats>> Snapshot(bool is_site) {
+        std::lock_guard guard(mutex_);
+        std::vector<std::pair<std::string, SimpleVectorStats>> result;
+        for(const auto& [name, counters] : is_site ? sites_ : types_) {
+            result.emplace_back(name, counters.Snapshot());
+        }
+        return result;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::pair<std::string, Counters>> types_;
+    std::deque<std::pair<std::string, Counters>> sites_;
+};
+
+// Счётчики места вызова, активного в текущем потоке
+inline thread_local Counters* current_site = nullptr;
+
+// Делает место вызова активным до конца области видимости
+class SiteScope {
+public:
+    explicit SiteScope(Counters& site) noexcept
+        : previous_(std::exchange(current_site, &site)) {
+    }
+
+    SiteScope(const SiteScope&) = delete;
+    SiteScope& operator=(const SiteScope&) = delete;
+
+    ~SiteScope() {
+        current_site = previous_;
+    }
+
+private:
+    Counters* previous_;
+};
+
+} // namespace simple_vector_stats
+
+// Хуки, которые вызывает Vector. Счётчики заводятся при первом обращении.
+// Хуки noexcept и вызываются в том числе из деструктора, поэтому регистрация,
+// которая выделяет память, не выпускает исключений: если она не удалась,
+// счётчики этой инстанциации не ведутся
+template <typename Vector>
+struct SimpleVectorStatsHook {
+    using Clock = std::chrono::steady_clock;
+    using GrowthTimer = Clock::time_point;
+
+    static simple_vector_stats::Counters* ForType() noexcept {
+        static simple_vector_stats::Counters* const counters = Register();
+        return counters;
+    }
+
+    static void OnAllocate(size_t capacity) noexcept {
+        if(simple_vector_stats::Counters* counters = ForType()) {
+            counters->OnAllocate(capacity);
+        }
+        if(simple_vector_stats::current_site != nullptr) {
+            simple_vector_stats::current_site->OnAllocate(capacity);
+        }
+    }
+
+    static GrowthTimer StartGrowth() noexcept {
+        return Clock::now();
+    }
+
+    static void OnRelocate(GrowthTimer start, size_t elements, size_t element_size) noexcept {
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        if(simple_vector_stats::Counters* counters = ForType()) {
+            counters->OnRelocate(elements, elements * element_size, ns);
+        }
+        if(simple_vector_stats::current_site != nullptr) {
+            simple_vector_stats::current_site->OnRelocate(elements, elements * element_size, ns);
+        }
+    }
+
+    static void OnRelease(size_t unused_elements, size_t element_size) noexcept {
+        if(simple_vector_stats::Counters* counters = ForType()) {
+            counters->OnRelease(unused_elements * element_size);
+        }
+        if(simple_vector_stats::current_site != nullptr) {
+            simple_vector_stats::current_site->OnRelease(unused_elements * element_size);
+        }
+    }
+
+    static SimpleVectorStats Snapshot() {
+        const simple_vector_stats::Counters* counters = ForType();
+        return counters != nullptr ? counters->Snapshot() : SimpleVectorStats();
+    }
+
+private:
+    static simple_vector_stats::Counters* Register() noexcept {
+        try {
+            return &simple_vector_stats::Registry::Instance().Get(typeid(Vector).name(), false);
+        } catch(...) {
+            return nullptr;
+        }
+    }
+};
+
+#define SIMPLE_VECTOR_STATS_CONCAT_IMPL(a, b) a##b
+#define SIMPLE_VECTOR_STATS_CONCAT(a, b) SIMPLE_VECTOR_STATS_CONCAT_IMPL(a, b)
+
+// Засчитывает рост векторов до конца текущей области видимости месту вызова name
+#define SIMPLE_VECTOR_STATS_SCOPE(name)                                                                     \
+    static simple_vector_stats::Counters& SIMPLE_VECTOR_STATS_CONCAT(simple_vector_site_, __LINE__) =       \
+        simple_vector_stats::Registry::Instance().Get(name, true);                                          \
+    simple_vector_stats::SiteScope SIMPLE_VECTOR_STATS_CONCAT(simple_vector_site_scope_, __LINE__)(         \
+        SIMPLE_VECTOR_STATS_CONCAT(simple_vector_site_, __LINE__))
+
+// Счётчики всех инстанциаций (по имени типа из typeid)
+inline std::vector<std::pair<std::string, SimpleVectorStats>> GetSimpleVectorTypeStats() {
+    return simple_vector_stats::Registry::Instance().Snapshot(false);
+}
+
+// Счётчики всех мест вызова, отмеченных SIMPLE_VECTOR_STATS_SCOPE
+inline std::vector<std::pair<std::string, SimpleVectorStats>> GetSimpleVectorSiteStats() {
+    return simple_vector_stats::Registry::Instance().Snapshot(true);
+}
+
+#else
+
+// Без SIMPLE_VECTOR_ENABLE_STATS хуки ничего не делают
+template <typename Vector>
+struct SimpleVectorStatsHook {
+    struct GrowthTimer {};
+
+    static void OnAllocate(size_t) noexcept {
+    }
+
+    static GrowthTimer StartGrowth() noexcept {
+        return {};
+    }
+
+    static void OnRelocate(GrowthTimer, size_t, size_t) noexcept {
+    }
+
+    static void OnRelease(size_t, size_t) noexcept {
+    }
+
+    static SimpleVectorStats Snapshot() {
+        return {};
+    }
+};
+
+#define SIMPLE_VECTOR_STATS_SCOPE(name) static_cast<void>(0)
+
+inline std::vector<std::pair<std::string, SimpleVectorStats>> GetSimpleVectorTypeStats() {
+    return {};
+}
+
+inline std::vector<std::pair<std::string, SimpleVectorStats>> GetSimpleVectorSiteStats() {
+    return {};
+}
+
+#endif
+
+// Снимок счётчиков одной инстанциации, например GetSimpleVectorStats<SimpleVector<int>>()
+template <typename Vector>
+SimpleVectorStats GetSimpleVectorStats() {
+    return SimpleVectorStatsHook<Vector>::Snapshot();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Категория итератора: range-операции заранее узнают длину прямых диапазонов
+// и работают поэлементно только с однопроходными (input) итераторами
+template <typename It, typename = void>
+struct IsInputIterator : std::false_type {};
+
+template <typename It>
+struct IsInputIterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+    : std::is_convertible<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag> {};
+
+template <typename It>
+inline constexpr bool IsForwardIteratorV =
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+template <typename It>
+using EnableIfInputIterator = std::enable_if_t<IsInputIterator<It>::value>;
+
+namespace vector_detail {
+
+// Создаёт элемент из args: круглыми скобками, а если такого конструктора нет -
+// фигурными, чтобы EmplaceBack работал и с агрегатами
+template <typename Type, typename... Args>
+constexpr Type Make(Args&&... args) {
+    if constexpr(std::is_constructible_v<Type, Args...>) {
+        return Type(std::forward<Args>(args)...);
+    } else {
+        return Type{std::forward<Args>(args)...};
+    }
+}
+
+} // namespace vector_detail
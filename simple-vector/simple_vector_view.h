@@ -0,0 +1,456 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+#if defined(__cpp_lib_span)
+#define SIMPLE_VECTOR_HAS_SPAN 1
+#include <ranges>
+#else
+#define SIMPLE_VECTOR_HAS_SPAN 0
+#endif
+
+template <typename Type>
+class SimpleVectorView;
+
+namespace view_detail {
+
+// Последовательность участков одинаковой ширины width, начинающихся через step элементов.
+// Участки не копируются: разыменование итератора строит SimpleVectorView на месте
+template <typename Type>
+class StridedViews {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = SimpleVectorView<Type>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = SimpleVectorView<Type>;
+
+        Iterator() noexcept = default;
+
+        Iterator(const StridedViews* range, size_t index) noexcept
+            : range_(range), index_(index) {
+        }
+
+        SimpleVectorView<Type> operator*() const noexcept {
+            return (*range_)[index_];
+        }
+
+        Iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const Iterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+
+    private:
+        const StridedViews* range_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    StridedViews(Type* data, size_t size, size_t width, size_t step, size_t count) noexcept
+        : data_(data), size_(size), width_(width), step_(step), count_(count) {
+    }
+
+    // Количество участков
+    size_t GetSize() const noexcept {
+        return count_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return count_ == 0;
+    }
+
+    // Последний участок может быть короче width (для Chunks)
+    SimpleVectorView<Type> operator[](size_t index) const noexcept {
+        assert(index < count_);
+        const size_t offset = index * step_;
+        return {data_ + offset, std::min(width_, size_ - offset)};
+    }
+
+    Iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    Iterator end() const noexcept {
+        return {this, count_};
+    }
+
+private:
+    Type* data_;
+    size_t size_;
+    size_t width_;
+    size_t step_;
+    size_t count_;
+};
+
+// Стадии ленивого конвейера. Каждая стадия толкает элементы в приёмник sink;
+// приёмник возвращает false, когда элементов больше не нужно. Все стадии
+// встраиваются друг в друга, так что конвейер выполняется одним циклом по исходным данным
+
+template <typename Type>
+struct SourceStage {
+    using Reference = Type&;
+    static constexpr bool kExactSize = true;
+
+    template <typename Sink>
+    void Run(Sink&& sink) const {
+        for(size_t i = 0; i < size; ++i) {
+            if(!sink(data[i])) {
+                return;
+            }
+        }
+    }
+
+    size_t SizeBound() const noexcept {
+        return size;
+    }
+
+    Type* data;
+    size_t size;
+};
+
+template <typename Prev, typename Func>
+struct MapStage {
+    using Reference = std::invoke_result_t<const Func&, typename Prev::Reference>;
+    static constexpr bool kExactSize = Prev::kExactSize;
+
+    template <typename Sink>
+    void Run(Sink&& sink) const {
+        prev.Run([&](typename Prev::Reference item) {
+            return sink(func(std::forward<typename Prev::Reference>(item)));
+        });
+    }
+
+    size_t SizeBound() const noexcept {
+        return prev.SizeBound();
+    }
+
+    Prev prev;
+    Func func;
+};
+
+template <typename Prev, typename Pred>
+struct FilterStage {
+    using Reference = typename Prev::Reference;
+    static constexpr bool kExactSize = false;
+
+    template <typename Sink>
+    void Run(Sink&& sink) const {
+        prev.Run([&](Reference item) {
+            return pred(std::as_const(item)) ? sink(std::forward<Reference>(item)) : true;
+        });
+    }
+
+    size_t SizeBound() const noexcept {
+        return prev.SizeBound();
+    }
+
+    Prev prev;
+    Pred pred;
+};
+
+template <typename Prev>
+struct TakeStage {
+    using Reference = typename Prev::Reference;
+    static constexpr bool kExactSize = Prev::kExactSize;
+
+    template <typename Sink>
+    void Run(Sink&& sink) const {
+        if(count == 0) {
+            return;
+        }
+        size_t left = count;
+        prev.Run([&](Reference item) {
+            return sink(std::forward<Reference>(item)) && --left != 0;
+        });
+    }
+
+    size_t SizeBound() const noexcept {
+        return std::min(prev.SizeBound(), count);
+    }
+
+    Prev prev;
+    size_t count;
+};
+
+} // namespace view_detail
+
+// Ленивый конвейер над SimpleVectorView. Map, Filter и Take ничего не вычисляют и не выделяют,
+// а только составляют стадии; данные проходят через все стадии одним циклом при ForEach или Collect.
+// Функции стадий хранятся по значению и вызываются как константные
+template <typename Stage>
+class LazyView {
+public:
+    using Reference = typename Stage::Reference;
+    using ValueType = std::remove_cv_t<std::remove_reference_t<Reference>>;
+
+    explicit LazyView(Stage stage)
+        : stage_(std::move(stage)) {
+    }
+
+    // Применяет func к каждому элементу
+    template <typename Func>
+    LazyView<view_detail::MapStage<Stage, Func>> Map(Func func) const {
+        return LazyView<view_detail::MapStage<Stage, Func>>({stage_, std::move(func)});
+    }
+
+    // Пропускает дальше только элементы, для которых pred истинен
+    template <typename Pred>
+    LazyView<view_detail::FilterStage<Stage, Pred>> Filter(Pred pred) const {
+        return LazyView<view_detail::FilterStage<Stage, Pred>>({stage_, std::move(pred)});
+    }
+
+    // Останавливает конвейер после count элементов
+    LazyView<view_detail::TakeStage<Stage>> Take(size_t count) const {
+        return LazyView<view_detail::TakeStage<Stage>>({stage_, count});
+    }
+
+    // Передаёт каждый элемент конвейера в func
+    template <typename Func>
+    void ForEach(Func func) const {
+        stage_.Run([&](Reference item) {
+            func(std::forward<Reference>(item));
+            return true;
+        });
+    }
+
+    // Вычисляет конвейер в SimpleVector. Память выделяется один раз заранее:
+    // ровно под результат, если его размер известен (нет Filter), иначе под верхнюю оценку
+    SimpleVector<ValueType> Collect() const {
+        SimpleVector<ValueType> result(::Reserve(stage_.SizeBound()));
+        CollectInto(result);
+        return result;
+    }
+
+    // Дописывает элементы конвейера в конец out
+    template <typename Alloc, typename Growth>
+    void CollectInto(SimpleVector<ValueType, Alloc, Growth>& out) const {
+        out.Reserve(out.GetSize() + stage_.SizeBound());
+        stage_.Run([&](Reference item) {
+            out.EmplaceBack(std::forward<Reference>(item));
+            return true;
+        });
+    }
+
+    // Верхняя оценка количества элементов; точное значение, если IsSizeExact()
+    size_t SizeBound() const noexcept {
+        return stage_.SizeBound();
+    }
+
+    static constexpr bool IsSizeExact() noexcept {
+        return Stage::kExactSize;
+    }
+
+private:
+    Stage stage_;
+};
+
+// Невладеющее представление непрерывного участка: указатель и длина.
+// Передаёт часть SimpleVector другому компоненту без копирования. Представление
+// не продлевает жизнь данных и становится недействительным при перевыделении
+// буфера вектора (вставка сверх ёмкости, Reserve, ShrinkToFit) и при его разрушении.
+// SimpleVectorView<const Type> - представление только для чтения
+template <typename Type>
+class SimpleVectorView {
+public:
+    using ValueType = std::remove_cv_t<Type>;
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr SimpleVectorView() noexcept = default;
+
+    constexpr SimpleVectorView(Type* data, size_t size) noexcept
+        : data_(data), size_(size) {
+    }
+
+    template <typename Alloc, typename Growth>
+    SimpleVectorView(SimpleVector<ValueType, Alloc, Growth>& vector) noexcept
+        : data_(vector.begin()), size_(vector.GetSize()) {
+    }
+
+    // Представление константного вектора возможно только для чтения
+    template <typename Alloc, typename Growth, typename Self = Type,
+              typename = std::enable_if_t<std::is_const_v<Self>>>
+    SimpleVectorView(const SimpleVector<ValueType, Alloc, Growth>& vector) noexcept
+        : data_(vector.begin()), size_(vector.GetSize()) {
+    }
+
+    // SimpleVectorView<Type> неявно приводится к SimpleVectorView<const Type>
+    template <typename Other,
+              typename = std::enable_if_t<std::is_convertible_v<Other (*)[], Type (*)[]>>>
+    constexpr SimpleVectorView(SimpleVectorView<Other> other) noexcept
+        : data_(other.Data()), size_(other.GetSize()) {
+    }
+
+#if SIMPLE_VECTOR_HAS_SPAN
+    template <typename Other, size_t Extent,
+              typename = std::enable_if_t<std::is_convertible_v<Other (*)[], Type (*)[]>>>
+    constexpr SimpleVectorView(std::span<Other, Extent> span) noexcept
+        : data_(span.data()), size_(span.size()) {
+    }
+#endif
+
+    constexpr Type* Data() const noexcept {
+        return data_;
+    }
+
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) const {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than view size"s);
+        }
+        return data_[index];
+    }
+
+    constexpr Type& Front() const noexcept {
+        assert(size_ != 0);
+        return data_[0];
+    }
+
+    constexpr Type& Back() const noexcept {
+        assert(size_ != 0);
+        return data_[size_ - 1];
+    }
+
+    constexpr Iterator begin() const noexcept {
+        return data_;
+    }
+
+    constexpr Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    constexpr ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    // Участок из не более чем count элементов, начиная с offset.
+    // Выбрасывает исключение std::out_of_range, если offset > size
+    SimpleVectorView Slice(size_t offset, size_t count = npos) const {
+        if(offset > size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Slice offset is greater than view size"s);
+        }
+        return {data_ + offset, std::min(count, size_ - offset)};
+    }
+
+    // Первые count элементов (или все, если их меньше)
+    SimpleVectorView First(size_t count) const noexcept {
+        return {data_, std::min(count, size_)};
+    }
+
+    // Последние count элементов (или все, если их меньше)
+    SimpleVectorView Last(size_t count) const noexcept {
+        const size_t result_size = std::min(count, size_);
+        return {data_ + size_ - result_size, result_size};
+    }
+
+    // Непересекающиеся участки по size элементов; последний может быть короче
+    view_detail::StridedViews<Type> Chunks(size_t size) const noexcept {
+        assert(size != 0);
+        return {data_, size_, size, size, (size_ + size - 1) / size};
+    }
+
+    // Все участки из size подряд идущих элементов со сдвигом на один элемент
+    view_detail::StridedViews<Type> Windows(size_t size) const noexcept {
+        assert(size != 0);
+        return {data_, size_, size, 1, size_ >= size ? size_ - size + 1 : 0};
+    }
+
+    // Начало ленивого конвейера над элементами представления
+    LazyView<view_detail::SourceStage<Type>> Lazy() const noexcept {
+        return LazyView<view_detail::SourceStage<Type>>({data_, size_});
+    }
+
+    template <typename Func>
+    auto Map(Func func) const {
+        return Lazy().Map(std::move(func));
+    }
+
+    template <typename Pred>
+    auto Filter(Pred pred) const {
+        return Lazy().Filter(std::move(pred));
+    }
+
+    auto Take(size_t count) const {
+        return Lazy().Take(count);
+    }
+
+    // Копирует элементы в новый SimpleVector
+    SimpleVector<ValueType> ToSimpleVector() const {
+        return SimpleVector<ValueType>(begin(), end());
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Type, typename Alloc, typename Growth>
+SimpleVectorView(SimpleVector<Type, Alloc, Growth>&) -> SimpleVectorView<Type>;
+
+template <typename Type, typename Alloc, typename Growth>
+SimpleVectorView(const SimpleVector<Type, Alloc, Growth>&) -> SimpleVectorView<const Type>;
+
+// Сравнивает содержимое, а не адреса
+template <typename Lhs, typename Rhs>
+bool operator==(SimpleVectorView<Lhs> lhs, SimpleVectorView<Rhs> rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Lhs, typename Rhs>
+bool operator!=(SimpleVectorView<Lhs> lhs, SimpleVectorView<Rhs> rhs) {
+    return !(lhs == rhs);
+}
+
+#if SIMPLE_VECTOR_HAS_SPAN
+// Представление - заимствованный непрерывный диапазон, поэтому std::span строится из него напрямую
+template <typename Type>
+inline constexpr bool std::ranges::enable_borrowed_range<SimpleVectorView<Type>> = true;
+#endif
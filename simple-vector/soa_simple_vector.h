@@ -0,0 +1,547 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Непрерывный участок одного столбца: указатель и длина.
+// Простые циклы по нему компилятор векторизует так же, как по обычному массиву
+template <typename Type>
+class ColumnSpan {
+public:
+    ColumnSpan(Type* data, size_t size) noexcept
+        : data_(data), size_(size) {
+    }
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    Type* begin() const noexcept {
+        return data_;
+    }
+
+    Type* end() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    Type* data_;
+    size_t size_;
+};
+
+// Вектор записей, хранящий каждое поле в отдельном столбце (structure of arrays).
+// Размер, вместимость и рост общие для всех столбцов и ведут себя как у SimpleVector,
+// столбец I доступен как ColumnSpan через Column<I>().
+// Строка - кортеж ссылок на поля: auto [id, price] = vector[i];
+// Итераторы строк - прокси: поддерживают арифметику произвольного доступа,
+// но разыменовываются в кортеж ссылок, а не в ссылку на запись.
+// Growth - политика роста из growth_policy.h, как у SimpleVector
+template <typename Growth, typename... Ts>
+class BasicSoaSimpleVector {
+    static_assert(sizeof...(Ts) > 0, "SoaSimpleVector needs at least one column");
+
+    using Columns = std::tuple<ArrayPtr<Ts>...>;
+    using Indexes = std::index_sequence_for<Ts...>;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    template <bool kConst>
+    class RowIterator {
+        using Owner = std::conditional_t<kConst, const BasicSoaSimpleVector, BasicSoaSimpleVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Ts...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, std::tuple<const Ts&...>, std::tuple<Ts&...>>;
+        using pointer = void;
+
+        RowIterator() = default;
+
+        RowIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner), index_(index) {
+        }
+
+        // Константный итератор из неконстантного
+        template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+        RowIterator(const RowIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_), index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        RowIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        RowIterator operator++(int) noexcept {
+            RowIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        RowIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        RowIterator operator--(int) noexcept {
+            RowIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        RowIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        RowIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend RowIterator operator+(RowIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator+(difference_type offset, RowIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend RowIterator operator-(RowIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ != rhs.index_;
+        }
+
+        friend bool operator<(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ > rhs.index_;
+        }
+
+        friend bool operator<=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ <= rhs.index_;
+        }
+
+        friend bool operator>=(const RowIterator& lhs, const RowIterator& rhs) noexcept {
+            return lhs.index_ >= rhs.index_;
+        }
+
+    private:
+        friend class RowIterator<!kConst>;
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using Iterator = RowIterator<false>;
+    using ConstIterator = RowIterator<true>;
+    using Row = std::tuple<Ts&...>;
+    using ConstRow = std::tuple<const Ts&...>;
+
+    BasicSoaSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size строк, поля которых инициализированы значением по умолчанию
+    explicit BasicSoaSimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    // Создаёт вектор с резервированной вместительностью
+    BasicSoaSimpleVector(ReserveProxyObj capacity) {
+        Reserve(capacity.GetValue());
+    }
+
+    //Копирующий конструктор
+    BasicSoaSimpleVector(const BasicSoaSimpleVector& other) {
+        Reserve(other.size_);
+        ConstructColumns(other.size_, [&](auto* dest, auto column) {
+            std::uninitialized_copy_n(other.template ColumnData<decltype(column)::value>(), other.size_, dest + size_);
+        });
+        size_ = other.size_;
+    }
+
+    //Копирующее присваивание
+    BasicSoaSimpleVector& operator=(const BasicSoaSimpleVector& rhs) {
+        if(this != &rhs) {
+            BasicSoaSimpleVector temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    //Перемещающий конструктор
+    BasicSoaSimpleVector(BasicSoaSimpleVector&& other) noexcept
+        : columns_(std::move(other.columns_)) {
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+    }
+
+    //Перемещающее присваивание
+    BasicSoaSimpleVector& operator=(BasicSoaSimpleVector&& rhs) noexcept {
+        if(this != &rhs) {
+            BasicSoaSimpleVector temp(std::move(rhs));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~BasicSoaSimpleVector() {
+        DestroyRows(0, size_);
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает кортеж ссылок на поля строки index
+    Row operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt(index, Indexes());
+    }
+
+    ConstRow operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt(index, Indexes());
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Row At(size_t index) {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return RowAt(index, Indexes());
+    }
+
+    ConstRow At(size_t index) const {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+        return RowAt(index, Indexes());
+    }
+
+    // Столбец I целиком
+    template <size_t I>
+    ColumnSpan<ColumnType<I>> Column() noexcept {
+        return ColumnSpan<ColumnType<I>>(ColumnData<I>(), size_);
+    }
+
+    template <size_t I>
+    ColumnSpan<const ColumnType<I>> Column() const noexcept {
+        return ColumnSpan<const ColumnType<I>>(ColumnData<I>(), size_);
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Добавляет строку в конец. Если поле не удалось создать, строка не добавляется
+    void PushBack(Ts... values) {
+        if(size_ == capacity_) {
+            Reallocate(NextCapacity(size_ + 1));
+        }
+        ConstructColumns(1, [&](auto* dest, auto column) {
+            new (dest + size_) ColumnType<decltype(column)::value>(std::move(std::get<decltype(column)::value>(std::tie(values...))));
+        });
+        ++size_;
+    }
+
+    // Вставляет строку перед pos и возвращает итератор на неё
+    Iterator Insert(ConstIterator pos, Ts... values) {
+        assert(pos.GetIndex() <= size_);
+        const size_t index = pos.GetIndex();
+        PushBack(std::move(values)...);
+        RotateLastTo(index, Indexes());
+        return Iterator(this, index);
+    }
+
+    // Удаляет строку pos и возвращает итератор на следующую
+    Iterator Erase(ConstIterator pos) {
+        assert(pos.GetIndex() < size_);
+        const size_t index = pos.GetIndex();
+        EraseRow(index, Indexes());
+        --size_;
+        return Iterator(this, index);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ != 0);
+        DestroyRows(size_ - 1, size_);
+        --size_;
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    // Изменяет количество строк, новые поля инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if(new_size <= size_) {
+            DestroyRows(new_size, size_);
+            size_ = new_size;
+            return;
+        }
+        if(new_size > capacity_) {
+            Reallocate(NextCapacity(new_size));
+        }
+        ConstructColumns(new_size - size_, [&](auto* dest, auto) {
+            std::uninitialized_value_construct_n(dest + size_, new_size - size_);
+        });
+        size_ = new_size;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if(new_capacity > capacity_) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    void swap(BasicSoaSimpleVector& other) noexcept {
+        SwapColumns(other, Indexes());
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+private:
+    template <size_t I>
+    ColumnType<I>* ColumnData() noexcept {
+        return std::get<I>(columns_).Get();
+    }
+
+    template <size_t I>
+    const ColumnType<I>* ColumnData() const noexcept {
+        return std::get<I>(columns_).Get();
+    }
+
+    template <size_t... Is>
+    Row RowAt(size_t index, std::index_sequence<Is...>) noexcept {
+        return Row(ColumnData<Is>()[index]...);
+    }
+
+    template <size_t... Is>
+    ConstRow RowAt(size_t index, std::index_sequence<Is...>) const noexcept {
+        return ConstRow(ColumnData<Is>()[index]...);
+    }
+
+    // Вместимость после роста: политика роста видит размер всей строки
+    size_t NextCapacity(size_t required) const noexcept {
+        return std::max(Growth::NextCapacity(capacity_, required, (sizeof(Ts) + ...)), required);
+    }
+
+    // Создаёт count элементов в каждом столбце: construct(column_data, integral_constant<I>).
+    // Если столбец бросил исключение, уже созданные элементы предыдущих столбцов разрушаются
+    template <typename Construct>
+    void ConstructColumns(size_t count, Construct construct) {
+        ConstructColumnsFrom<0>(count, construct);
+    }
+
+    template <size_t I, typename Construct>
+    void ConstructColumnsFrom(size_t count, Construct& construct) {
+        if constexpr(I < sizeof...(Ts)) {
+            construct(ColumnData<I>(), std::integral_constant<size_t, I>());
+            try {
+                ConstructColumnsFrom<I + 1>(count, construct);
+            } catch(...) {
+                std::destroy_n(ColumnData<I>() + size_, count);
+                throw;
+            }
+        }
+    }
+
+    void DestroyRows(size_t first, size_t last) noexcept {
+        DestroyRows(first, last, Indexes());
+    }
+
+    template <size_t... Is>
+    void DestroyRows(size_t first, size_t last, std::index_sequence<Is...>) noexcept {
+        (std::destroy(ColumnData<Is>() + first, ColumnData<Is>() + last), ...);
+    }
+
+    // Переносит столбцы в новые буферы вместимостью new_capacity.
+    // Сначала копируются столбцы, перенос которых может бросить исключение, и только после
+    // этого без исключений перемещаются остальные. Поэтому при исключении исходные элементы
+    // всех столбцов остаются целыми (кроме некопируемых столбцов с бросающим перемещением)
+    void Reallocate(size_t new_capacity) {
+        Columns fresh{ArrayPtr<Ts>(new_capacity)...};
+        CopyColumnsFrom<0>(fresh);
+        MoveColumns(fresh, Indexes());
+        DestroyRelocated(Indexes());
+        columns_.swap(fresh);
+        capacity_ = new_capacity;
+    }
+
+    template <typename Type>
+    static constexpr bool kRelocatesNothrow = IsTriviallyRelocatableV<Type> || std::is_nothrow_move_constructible_v<Type>;
+
+    template <size_t I>
+    void CopyColumnsFrom(Columns& fresh) {
+        if constexpr(I < sizeof...(Ts)) {
+            using Type = ColumnType<I>;
+            if constexpr(kRelocatesNothrow<Type>) {
+                CopyColumnsFrom<I + 1>(fresh);
+            } else {
+                Type* dest = std::get<I>(fresh).Get();
+                if constexpr(std::is_copy_constructible_v<Type>) {
+                    std::uninitialized_copy_n(ColumnData<I>(), size_, dest);
+                } else {
+                    std::uninitialized_move_n(ColumnData<I>(), size_, dest);
+                }
+                try {
+                    CopyColumnsFrom<I + 1>(fresh);
+                } catch(...) {
+                    std::destroy_n(dest, size_);
+                    throw;
+                }
+            }
+        }
+    }
+
+    template <size_t... Is>
+    void MoveColumns(Columns& fresh, std::index_sequence<Is...>) noexcept {
+        (MoveColumn<Is>(fresh), ...);
+    }
+
+    template <size_t I>
+    void MoveColumn(Columns& fresh) noexcept {
+        using Type = ColumnType<I>;
+        Type* dest = std::get<I>(fresh).Get();
+        if constexpr(IsTriviallyRelocatableV<Type>) {
+            if(size_ != 0) {
+                std::memcpy(static_cast<void*>(dest), ColumnData<I>(), size_ * sizeof(Type));
+            }
+        } else if constexpr(std::is_nothrow_move_constructible_v<Type>) {
+            std::uninitialized_move_n(ColumnData<I>(), size_, dest);
+        }
+    }
+
+    // Тривиально перенесённые столбцы уже живут в новых буферах и не разрушаются
+    template <size_t... Is>
+    void DestroyRelocated(std::index_sequence<Is...>) noexcept {
+        (DestroyRelocatedColumn<Is>(), ...);
+    }
+
+    template <size_t I>
+    void DestroyRelocatedColumn() noexcept {
+        if constexpr(!IsTriviallyRelocatableV<ColumnType<I>>) {
+            std::destroy_n(ColumnData<I>(), size_);
+        }
+    }
+
+    // Сдвигает только что добавленную последнюю строку в позицию index
+    template <size_t... Is>
+    void RotateLastTo(size_t index, std::index_sequence<Is...>) {
+        (std::rotate(ColumnData<Is>() + index, ColumnData<Is>() + size_ - 1, ColumnData<Is>() + size_), ...);
+    }
+
+    template <size_t... Is>
+    void EraseRow(size_t index, std::index_sequence<Is...>) {
+        ((std::move(ColumnData<Is>() + index + 1, ColumnData<Is>() + size_, ColumnData<Is>() + index),
+          std::destroy_at(ColumnData<Is>() + size_ - 1)),
+         ...);
+    }
+
+    template <size_t... Is>
+    void SwapColumns(BasicSoaSimpleVector& other, std::index_sequence<Is...>) noexcept {
+        (std::get<Is>(columns_).swap(std::get<Is>(other.columns_)), ...);
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Вектор записей с ростом вдвое
+template <typename... Ts>
+using SoaSimpleVector = BasicSoaSimpleVector<DoublingGrowth, Ts...>;
+
+template <typename Growth, typename... Ts>
+inline bool operator==(const BasicSoaSimpleVector<Growth, Ts...>& lhs, const BasicSoaSimpleVector<Growth, Ts...>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Growth, typename... Ts>
+inline bool operator!=(const BasicSoaSimpleVector<Growth, Ts...>& lhs, const BasicSoaSimpleVector<Growth, Ts...>& rhs) {
+    return !(lhs == rhs);
+}
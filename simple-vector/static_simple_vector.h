@@ -0,0 +1,443 @@
+#pragma once
+
+#include "simple_vector_traits.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// В C++20 StaticSimpleVector полностью constexpr: таблицы можно строить при компиляции.
+// В C++17 те же функции работают только во время выполнения
+#if __cplusplus >= 202002L && defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_is_constant_evaluated)
+#define SIMPLE_VECTOR_CONSTEXPR20 constexpr
+#define SIMPLE_VECTOR_HAS_CONSTEXPR20 1
+#else
+#define SIMPLE_VECTOR_CONSTEXPR20
+#define SIMPLE_VECTOR_HAS_CONSTEXPR20 0
+#endif
+
+// Политики переполнения StaticSimpleVector. Overflow() вызывается, когда элементы
+// не помещаются во вместимость. Если он вернул управление, операция ничего не меняет
+// и сообщает о неудаче: PushBack и Resize возвращают false, EmplaceBack - nullptr,
+// Insert и Emplace - end(). При вычислении на этапе компиляции AssertOverflow и ThrowOverflow
+// дают ошибку компиляции (вызов не-constexpr функции или throw), а RejectOverflow,
+// как и во время выполнения, просто сообщает о неудаче - результат нужно проверять
+
+// Переполнение - ошибка программы: assert в отладочной сборке, abort в остальных
+struct AssertOverflow {
+    [[noreturn]] static void Overflow() noexcept {
+        assert(!"StaticSimpleVector capacity exceeded");
+        std::abort();
+    }
+};
+
+// Выбрасывает std::length_error
+struct ThrowOverflow {
+    [[noreturn]] static void Overflow() {
+        using namespace std::literals;
+        throw std::length_error("StaticSimpleVector capacity exceeded"s);
+    }
+};
+
+// Отказывается от операции, вызывающий проверяет результат
+struct RejectOverflow {
+    static constexpr void Overflow() noexcept {
+    }
+};
+
+namespace static_simple_vector_detail {
+
+// Память под Capacity элементов внутри объекта. Для тривиальных типов - обычный массив:
+// во время выполнения он не инициализируется, а при вычислении на этапе компиляции
+// заполняется значениями по умолчанию, чтобы результат можно было сохранить в constexpr-переменной
+template <typename Type, size_t Capacity,
+          bool = std::is_trivially_default_constructible_v<Type> && std::is_trivially_destructible_v<Type>>
+struct Storage {
+    SIMPLE_VECTOR_CONSTEXPR20 Storage() noexcept {
+#if SIMPLE_VECTOR_HAS_CONSTEXPR20
+        if(std::is_constant_evaluated()) {
+            for(Type& item : items) {
+                item = Type();
+            }
+        }
+#endif
+    }
+
+    Type items[Capacity];
+};
+
+// Для остальных типов - объединение: элементы создаются и разрушаются вектором
+template <typename Type, size_t Capacity>
+struct Storage<Type, Capacity, false> {
+    SIMPLE_VECTOR_CONSTEXPR20 Storage() noexcept {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ~Storage() {
+    }
+
+    union {
+        Type items[Capacity];
+    };
+};
+
+} // namespace static_simple_vector_detail
+
+// Вектор с вместимостью Capacity, известной при компиляции. Элементы хранятся
+// в выровненном буфере внутри самого объекта: куча не используется совсем.
+// Интерфейс повторяет SimpleVector; поведение при переполнении задаёт политика Overflow
+template <typename Type, size_t Capacity, typename Overflow = AssertOverflow>
+class StaticSimpleVector {
+    static_assert(Capacity > 0, "StaticSimpleVector capacity must be positive");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using OverflowPolicy = Overflow;
+
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию.
+    // Если size больше вместимости и политика не прервала выполнение, вектор пуст
+    SIMPLE_VECTOR_CONSTEXPR20 explicit StaticSimpleVector(size_t size) {
+        Resize(size);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector(size_t size, const Type& value) {
+        if(Fits(size)) {
+            for(; size_ < size; ++size_) {
+                Construct(Data() + size_, value);
+            }
+        }
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector(std::initializer_list<Type> init)
+        : StaticSimpleVector(init.begin(), init.end()) {
+    }
+
+    // Создаёт вектор из диапазона [first, last)
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector(InputIt first, InputIt last) {
+        Append(first, last);
+    }
+
+    //Копирующий конструктор
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector(const StaticSimpleVector& other) {
+        Append(other.begin(), other.end());
+    }
+
+    //Перемещающий конструктор: элементы other перемещаются по одному, other остаётся с перемещёнными значениями
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector(StaticSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        for(; size_ < other.size_; ++size_) {
+            Construct(Data() + size_, std::move(other.Data()[size_]));
+        }
+    }
+
+    //Копирующее присваивание
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector& operator=(const StaticSimpleVector& rhs) {
+        if(this != &rhs) {
+            Assign(rhs.begin(), rhs.size_);
+        }
+        return *this;
+    }
+
+    //Перемещающее присваивание
+    SIMPLE_VECTOR_CONSTEXPR20 StaticSimpleVector& operator=(StaticSimpleVector&& rhs) noexcept(std::is_nothrow_move_assignable_v<Type> && std::is_nothrow_move_constructible_v<Type>) {
+        if(this != &rhs) {
+            Assign(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+        return *this;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ~StaticSimpleVector() {
+        Destroy(begin(), end());
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t GetCapacity() noexcept {
+        return Capacity;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 bool IsFull() const noexcept {
+        return size_ == Capacity;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    SIMPLE_VECTOR_CONSTEXPR20 Type& At(size_t index) {
+        CheckIndex(index);
+        return Data()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 const Type& At(size_t index) const {
+        CheckIndex(index);
+        return Data()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator begin() noexcept {
+        return Data();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 void Clear() noexcept {
+        Destroy(begin(), end());
+        size_ = 0;
+    }
+
+    // Изменяет размер, новые элементы инициализируются значением по умолчанию.
+    // Возвращает false, если new_size не помещается и политика не прервала выполнение
+    SIMPLE_VECTOR_CONSTEXPR20 bool Resize(size_t new_size) {
+        if(!Fits(new_size)) {
+            return false;
+        }
+        for(; size_ < new_size; ++size_) {
+            Construct(Data() + size_);
+        }
+        Destroy(Data() + new_size, end());
+        size_ = new_size;
+        return true;
+    }
+
+    // Память уже выделена: проверяет только, что new_capacity помещается
+    SIMPLE_VECTOR_CONSTEXPR20 bool Reserve(size_t new_capacity) {
+        return Fits(new_capacity);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 bool PushBack(const Type& item) {
+        return EmplaceBack(item) != nullptr;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 bool PushBack(Type&& item) {
+        return EmplaceBack(std::move(item)) != nullptr;
+    }
+
+    // Создаёт элемент в конце вектора, возвращает указатель на него
+    // (nullptr, если места нет и политика не прервала выполнение)
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR20 Type* EmplaceBack(Args&&... args) {
+        if(!Fits(size_ + 1)) {
+            return nullptr;
+        }
+        Type* item = Construct(end(), std::forward<Args>(args)...);
+        ++size_;
+        return item;
+    }
+
+    // Создаёт элемент перед pos, возвращает итератор на него (end(), если места нет).
+    // args могут ссылаться на элементы вектора: элемент создаётся до сдвига
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = pos - cbegin();
+        if(!Fits(size_ + 1)) {
+            return end();
+        }
+        if(index == size_) {
+            return EmplaceBack(std::forward<Args>(args)...);
+        }
+        Type item = vector_detail::Make<Type>(std::forward<Args>(args)...);
+        Construct(end(), std::move(Data()[size_ - 1]));
+        ++size_;
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+        Data()[index] = std::move(item);
+        return begin() + index;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Дописывает элементы [first, last). Возвращает false, если все не поместились:
+    // тогда вектор не меняется
+    template <typename InputIt, typename = EnableIfInputIterator<InputIt>>
+    SIMPLE_VECTOR_CONSTEXPR20 bool Append(InputIt first, InputIt last) {
+        const size_t old_size = size_;
+        for(; first != last; ++first) {
+            if(EmplaceBack(*first) == nullptr) {
+                Destroy(Data() + old_size, end());
+                size_ = old_size;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 void PopBack() noexcept {
+        assert(size_ != 0);
+        --size_;
+        Destroy(end(), end() + 1);
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        Iterator res = begin() + (pos - cbegin());
+        std::move(res + 1, end(), res);
+        PopBack();
+        return res;
+    }
+
+    // Удаляет элементы [first, last), возвращает итератор на элемент, следовавший за ними
+    SIMPLE_VECTOR_CONSTEXPR20 Iterator EraseRange(ConstIterator first, ConstIterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        Iterator res = begin() + (first - cbegin());
+        Iterator new_end = std::move(res + (last - first), end(), res);
+        Destroy(new_end, end());
+        size_ = new_end - begin();
+        return res;
+    }
+
+    // Обменивает элементы с другим вектором поэлементно
+    SIMPLE_VECTOR_CONSTEXPR20 void swap(StaticSimpleVector& other) noexcept(std::is_nothrow_swappable_v<Type> && std::is_nothrow_move_constructible_v<Type>) {
+        StaticSimpleVector& shorter = size_ < other.size_ ? *this : other;
+        StaticSimpleVector& longer = size_ < other.size_ ? other : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        for(size_t i = shorter.size_; i < longer.size_; ++i) {
+            Construct(shorter.Data() + i, std::move(longer.Data()[i]));
+        }
+        Destroy(longer.begin() + shorter.size_, longer.end());
+        std::swap(size_, other.size_);
+    }
+
+private:
+    SIMPLE_VECTOR_CONSTEXPR20 Type* Data() noexcept {
+        return storage_.items;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 const Type* Data() const noexcept {
+        return storage_.items;
+    }
+
+    // Проверяет, что count элементов помещаются; иначе вызывает политику
+    SIMPLE_VECTOR_CONSTEXPR20 static bool Fits(size_t count) {
+        if(count > Capacity) {
+            Overflow::Overflow();
+            return false;
+        }
+        return true;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR20 void CheckIndex(size_t index) const {
+        if(index >= size_) {
+            using namespace std::literals;
+            throw std::out_of_range("Index is greater than vector size"s);
+        }
+    }
+
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR20 static Type* Construct(Type* raw, Args&&... args) {
+#if SIMPLE_VECTOR_HAS_CONSTEXPR20
+        return std::construct_at(raw, std::forward<Args>(args)...);
+#else
+        if constexpr(std::is_constructible_v<Type, Args...>) {
+            return ::new (static_cast<void*>(raw)) Type(std::forward<Args>(args)...);
+        } else {
+            return ::new (static_cast<void*>(raw)) Type{std::forward<Args>(args)...};
+        }
+#endif
+    }
+
+    // Тривиально разрушаемые элементы не разрушаются: иначе результат вычисления
+    // при компиляции содержал бы объекты с закончившимся временем жизни
+    SIMPLE_VECTOR_CONSTEXPR20 static void Destroy(Iterator first, Iterator last) noexcept {
+        if constexpr(!std::is_trivially_destructible_v<Type>) {
+            for(; first != last; ++first) {
+                first->~Type();
+            }
+        }
+    }
+
+    // Заменяет содержимое count элементами из source: общие присваиваются, лишние создаются или разрушаются
+    template <typename It>
+    SIMPLE_VECTOR_CONSTEXPR20 void Assign(It source, size_t count) {
+        const size_t common = std::min(size_, count);
+        for(size_t i = 0; i < common; ++i, ++source) {
+            Data()[i] = *source;
+        }
+        for(; size_ < count; ++size_, ++source) {
+            Construct(Data() + size_, *source);
+        }
+        Destroy(Data() + count, end());
+        size_ = count;
+    }
+
+    static_simple_vector_detail::Storage<Type, Capacity> storage_;
+    size_t size_ = 0;
+};
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator==(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator!=(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator<(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator<=(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator>(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t Capacity, typename Overflow>
+SIMPLE_VECTOR_CONSTEXPR20 bool operator>=(const StaticSimpleVector<Type, Capacity, Overflow>& lhs, const StaticSimpleVector<Type, Capacity, Overflow>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "execution_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing): у каждого потока своя очередь,
+// свои задачи он берёт с конца, а опустев, забирает задачи из начала чужих очередей.
+// Задачи из потоков пула попадают в очередь этого же потока, остальные раскладываются по кругу.
+class ThreadPool {
+public:
+    // Запускает threads рабочих потоков. Вызывающий ParallelFor поток тоже выполняет работу,
+    // поэтому пул из 0 потоков допустим: всё выполнится в вызывающем потоке
+    explicit ThreadPool(size_t threads) {
+        queues_.reserve(threads);
+        for(size_t i = 0; i < threads; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(threads);
+        for(size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this, i] {
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Дожидается выполнения всех поставленных задач и останавливает потоки
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for(std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Общий пул на все ядра машины (одно ядро остаётся вызывающему потоку)
+    static ThreadPool& Default() {
+        static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return pool;
+    }
+
+    // Сколько потоков одновременно выполняют ParallelFor: рабочие и вызывающий
+    size_t GetConcurrency() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    // Ставит задачу в очередь
+    void Submit(std::function<void()> task) {
+        if(workers_.empty()) {
+            task();
+            return;
+        }
+        const size_t index = current_pool_ == this ? current_index_ : next_queue_++ % queues_.size();
+        {
+            std::lock_guard guard(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard guard(sleep_mutex_);
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    // Вызывает body(chunk) для каждого chunk из [0, chunks) и ждёт завершения.
+    // Куски разбирают вызывающий поток и до GetConcurrency() - 1 рабочих.
+    // Первое выброшенное исключение пробрасывается после завершения всех кусков
+    template <typename Body>
+    void ParallelFor(size_t chunks, Body&& body) {
+        if(chunks == 0) {
+            return;
+        }
+        if(chunks == 1 || workers_.empty()) {
+            for(size_t chunk = 0; chunk < chunks; ++chunk) {
+                body(chunk);
+            }
+            return;
+        }
+        auto job = std::make_shared<Job<Body>>(body, chunks);
+        const size_t helpers = std::min(workers_.size(), chunks - 1);
+        for(size_t i = 0; i < helpers; ++i) {
+            Submit([job] {
+                job->Run();
+            });
+        }
+        job->Run();
+        job->Wait();
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Общее состояние ParallelFor. Помощники, запущенные после разбора всех кусков,
+    // не трогают body, поэтому он может жить на стеке вызывающего потока
+    template <typename Body>
+    struct Job {
+        Job(Body& body, size_t chunks)
+            : body(body), chunks(chunks) {
+        }
+
+        void Run() {
+            for(size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+                try {
+                    body(chunk);
+                } catch(...) {
+                    std::lock_guard guard(mutex);
+                    if(!error) {
+                        error = std::current_exception();
+                    }
+                }
+                if(done.fetch_add(1) + 1 == chunks) {
+                    std::lock_guard guard(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+
+        void Wait() {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [this] {
+                return done.load() == chunks;
+            });
+            if(error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Body& body;
+        const size_t chunks;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+
+    void WorkerLoop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        while(true) {
+            {
+                std::unique_lock lock(sleep_mutex_);
+                wake_.wait(lock, [this] {
+                    return stop_ || pending_ != 0;
+                });
+                if(pending_ == 0) {
+                    return;
+                }
+                --pending_;
+            }
+            // Задача точно есть в одной из очередей: pending_ уменьшается только здесь
+            std::function<void()> task;
+            while(!TryTake(index, task)) {
+                std::this_thread::yield();
+            }
+            task();
+        }
+    }
+
+    // Берёт задачу с конца своей очереди или крадёт из начала чужой
+    bool TryTake(size_t index, std::function<void()>& task) {
+        {
+            Queue& own = *queues_[index];
+            std::lock_guard guard(own.mutex);
+            if(!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for(size_t offset = 1; offset < queues_.size(); ++offset) {
+            Queue& victim = *queues_[(index + offset) % queues_.size()];
+            std::lock_guard guard(victim.mutex);
+            if(!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    size_t pending_ = 0;
+    bool stop_ = false;
+
+    static inline thread_local ThreadPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+};
+
+// Параллельное выполнение на пуле pool
+inline ExecutionPolicy Parallel(ThreadPool& pool = ThreadPool::Default()) noexcept {
+    return ExecutionPolicy(&pool, pool.GetConcurrency(),
+                           [](ThreadPool* target, size_t chunks, void* body, ExecutionPolicy::ChunkFn call) {
+        target->ParallelFor(chunks, [body, call](size_t chunk) {
+            call(body, chunk);
+        });
+    });
+}